@@ -0,0 +1,200 @@
+#include "AntColony.h"
+
+#define EPSILON 1e-7
+
+AntColony::AntColony(const DistanceView &view, unsigned int threads, unsigned int seed):
+    view(view), n(view.size()), threads(threads) {
+    if (this->threads == 0) {
+        this->threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (unsigned int id = 0; id < this->threads; id++) {
+        rngs.emplace_back(seed * 7919 + id);
+    }
+
+    std::vector<std::vector<int>> lists = view.nearestNeighbors(ACO_CANDIDATES);
+    k = 1;
+    for (auto &list : lists) {
+        k = std::max(k, (int) list.size());
+    }
+
+    // every row starts at a cache line: the stride is rounded up to a whole number of cache lines
+    int perLine = CACHE_LINE / sizeof(double);
+    stride = (k + perLine - 1) / perLine * perLine;
+
+    std::size_t size = 3 * (std::size_t) n * stride * sizeof(double);
+    std::size_t space = size + CACHE_LINE;
+    storage.reset(new char[space]);
+    void *base = storage.get();
+    std::align(CACHE_LINE, size, base, space);
+    pheromone = static_cast<double *>(base);
+    choice = pheromone + (std::size_t) n * stride;
+    heuristic = choice + (std::size_t) n * stride;
+
+    candidates.assign((std::size_t) n * stride, -1);
+    degree.resize(n);
+    for (int c = 0; c < n; c++) {
+        degree[c] = lists[c].size();
+        for (int j = 0; j < stride; j++) {
+            std::size_t slot = (std::size_t) c * stride + j;
+            if (j < degree[c]) {
+                candidates[slot] = lists[c][j];
+                heuristic[slot] = std::pow(1.0 / std::max(view.distance(c, lists[c][j]), EPSILON), ACO_BETA);
+            } else {
+                heuristic[slot] = 0;
+            }
+        }
+    }
+
+    for (auto &list : lists) {
+        if (list.size() > 10) list.resize(10);
+    }
+    neighbors = std::move(lists);
+}
+
+const std::vector<std::pair<double, double>> &AntColony::getHistory() const {
+    return history;
+}
+
+unsigned long long AntColony::getIterations() const {
+    return iterations;
+}
+
+void AntColony::reset(double value) {
+    for (std::size_t slot = 0; slot < (std::size_t) n * stride; slot++) {
+        pheromone[slot] = value;
+        choice[slot] = value * heuristic[slot];
+    }
+}
+
+void AntColony::update(const Tour &tour, double length) {
+    double deposit = 1.0 / length;
+    parallelFor(n, [&](unsigned int, int c) {
+        int next = tour.next(c), prev = tour.prev(c);
+        std::size_t row = (std::size_t) c * stride;
+        for (int j = 0; j < degree[c]; j++) {
+            double value = (1 - ACO_EVAPORATION) * pheromone[row + j];
+            if (candidates[row + j] == next || candidates[row + j] == prev) {
+                value += deposit;
+            }
+            value = std::min(maxPheromone, std::max(minPheromone, value));
+            pheromone[row + j] = value;
+            choice[row + j] = value * heuristic[row + j];
+        }
+    });
+}
+
+std::vector<int> AntColony::construct(std::mt19937 &rng) const {
+    std::vector<int> order;
+    order.reserve(n);
+    std::vector<bool> visited(n, false);
+    std::vector<int> unvisited(n), where(n);
+    for (int c = 0; c < n; c++) {
+        unvisited[c] = where[c] = c;
+    }
+    std::vector<double> weights(k);
+    std::uniform_real_distribution<double> uniform(0, 1);
+
+    auto visit = [&](int c) {
+        int last = unvisited.back();
+        unvisited[where[c]] = last;
+        where[last] = where[c];
+        unvisited.pop_back();
+        visited[c] = true;
+        order.push_back(c);
+    };
+
+    int c = std::uniform_int_distribution<int>(0, n - 1)(rng);
+    visit(c);
+    while ((int) order.size() < n) {
+        std::size_t row = (std::size_t) c * stride;
+        double total = 0;
+        for (int j = 0; j < degree[c]; j++) {
+            weights[j] = visited[candidates[row + j]] ? 0 : choice[row + j];
+            total += weights[j];
+        }
+
+        int next = -1;
+        if (total > 0) {
+            double r = uniform(rng) * total;
+            for (int j = 0; j < degree[c]; j++) {
+                if (weights[j] > 0) {
+                    next = candidates[row + j];
+                    r -= weights[j];
+                    if (r <= 0) break;
+                }
+            }
+        } else {
+            double min = INF;
+            for (int u : unvisited) {
+                if (view.distance(c, u) < min) {
+                    min = view.distance(c, u);
+                    next = u;
+                }
+            }
+        }
+
+        visit(next);
+        c = next;
+    }
+
+    return order;
+}
+
+double AntColony::optimize(Tour &best, double timeLimit) {
+    history.clear();
+    iterations = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(timeLimit));
+
+    std::vector<std::unique_ptr<LocalSearch>> searches;
+    for (unsigned int id = 0; id < threads; id++) {
+        searches.emplace_back(new LocalSearch(view, neighbors));
+    }
+
+    std::vector<Tour> ants(ACO_ANTS);
+    std::vector<double> lengths(ACO_ANTS);
+    double bestLength = INF;
+    int sinceImprovement = 0;
+    reset(1.0);
+
+    do {
+        parallelFor(ACO_ANTS, [&](unsigned int id, int ant) {
+            if (iterations > 0 && std::chrono::steady_clock::now() >= deadline) {
+                lengths[ant] = INF;
+                return;
+            }
+            ants[ant] = Tour(construct(rngs[id]));
+            lengths[ant] = searches[id]->optimize(ants[ant]);
+        });
+
+        int iterationBest = std::min_element(lengths.begin(), lengths.end()) - lengths.begin();
+        if (lengths[iterationBest] == INF) {
+            break;
+        }
+        iterations++;
+
+        if (lengths[iterationBest] < bestLength - EPSILON) {
+            bestLength = lengths[iterationBest];
+            best = ants[iterationBest];
+            history.emplace_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(), bestLength);
+            maxPheromone = 1.0 / (ACO_EVAPORATION * bestLength);
+            minPheromone = maxPheromone / (2.0 * n);
+            sinceImprovement = 0;
+        } else {
+            sinceImprovement++;
+        }
+
+        if (iterations == 1 || sinceImprovement >= ACO_RESTART_ITERATIONS) {
+            reset(maxPheromone);
+            sinceImprovement = 0;
+        } else if (iterations % ACO_BEST_SO_FAR_PERIOD == 0) {
+            update(best, bestLength);
+        } else {
+            update(ants[iterationBest], lengths[iterationBest]);
+        }
+    } while (std::chrono::steady_clock::now() < deadline);
+
+    return bestLength;
+}
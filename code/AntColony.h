@@ -0,0 +1,134 @@
+#ifndef ROUTING_ALGORITHM_ANT_COLONY_H
+#define ROUTING_ALGORITHM_ANT_COLONY_H
+
+/**
+* @file AntColony.h
+* @brief Contains the declaration of the AntColony class.
+* @author Luiz, Pedro e Raphael
+* @date 02/06/2023
+*/
+
+#include <vector>
+#include <random>
+#include <thread>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <algorithm>
+
+#include "data_structures/DistanceView.h"
+#include "data_structures/Tour.h"
+#include "LocalSearch.h"
+
+#define ACO_ANTS 25
+#define ACO_CANDIDATES 20
+#define ACO_BETA 2.0
+#define ACO_EVAPORATION 0.2
+#define ACO_BEST_SO_FAR_PERIOD 5
+#define ACO_RESTART_ITERATIONS 50
+#define CACHE_LINE 64
+
+/**
+ * @class AntColony
+ * @brief Parallel MAX-MIN ant system restricted to candidate edges.
+ *
+ * The pheromone of the ACO_CANDIDATES nearest neighbours of every city is kept in one flat array whose rows are
+ * padded to a multiple of CACHE_LINE bytes and aligned to it, so the row of a city never shares a cache line with
+ * another row. The ants of each iteration are split between the threads, each with its own random number generator
+ * and LocalSearch, and choose among the unvisited candidates with probability proportional to tau * (1 / d)^ACO_BETA,
+ * falling back to the closest unvisited city. After the local search of every ant the pheromone rows are evaporated
+ * and reinforced with the iteration best (or, every ACO_BEST_SO_FAR_PERIOD iterations, the best-so-far) tour, each
+ * thread updating its own block of rows, so no locks or atomics are needed.
+ */
+class AntColony {
+public:
+    /**
+    * @brief Constructs an AntColony object and builds the candidate lists and the pheromone table.
+    * @param view The distances between the cities.
+    * @param threads The number of threads, or 0 to use one per hardware thread.
+    * @param seed The seed of the random number generators.
+    * @complexity O(n^2) on dense views, see DistanceView::nearestNeighbors.
+    */
+    AntColony(const DistanceView &view, unsigned int threads = 0, unsigned int seed = 0);
+
+    /**
+    * @brief Runs the colony until the time limit is reached.
+    * @param best[out] The best tour found.
+    * @param timeLimit The wall-clock budget in seconds.
+    * @return The length of the best tour found.
+    * @complexity O(ACO_ANTS (n ACO_CANDIDATES + local search)) per iteration, split between the threads.
+    */
+    double optimize(Tour &best, double timeLimit);
+
+    /**
+    * @brief Returns the time-to-quality curve of the last call to optimize().
+    * @return A pair (seconds since the start, length) for every improvement of the best tour.
+    */
+    const std::vector<std::pair<double, double>> &getHistory() const;
+
+    /**
+    * @brief Returns the number of iterations of the last call to optimize().
+    */
+    unsigned long long getIterations() const;
+
+private:
+    const DistanceView &view;
+    int n;
+    int k;
+    int stride;
+    unsigned int threads;
+
+    std::vector<std::vector<int>> neighbors;
+    std::vector<int> candidates;
+    std::vector<int> degree;
+    std::unique_ptr<char[]> storage;
+    double *pheromone = nullptr;
+    double *choice = nullptr;
+    double *heuristic = nullptr;
+    double minPheromone = 0, maxPheromone = 0;
+
+    std::vector<std::mt19937> rngs;
+    std::vector<std::pair<double, double>> history;
+    unsigned long long iterations = 0;
+
+    /**
+    * @brief Runs f(thread, i) for every i in [0, count), splitting the range in contiguous blocks between the threads.
+    */
+    template <class F>
+    void parallelFor(int count, F f) const;
+
+    /**
+    * @brief Builds the tour of one ant.
+    * @param rng The random number generator of the thread.
+    * @return The cities in the order they were visited.
+    */
+    std::vector<int> construct(std::mt19937 &rng) const;
+
+    /**
+    * @brief Sets every pheromone to value and recomputes the choice table.
+    */
+    void reset(double value);
+
+    /**
+    * @brief Evaporates the pheromone and reinforces the edges of a tour, clamped to [minPheromone, maxPheromone].
+    */
+    void update(const Tour &tour, double length);
+};
+
+template <class F>
+void AntColony::parallelFor(int count, F f) const {
+    std::vector<std::thread> pool;
+    for (unsigned int id = 0; id < threads; id++) {
+        int begin = (long long) count * id / threads, end = (long long) count * (id + 1) / threads;
+        pool.emplace_back([begin, end, id, &f]() {
+            for (int i = begin; i < end; i++) {
+                f(id, i);
+            }
+        });
+    }
+    for (auto &t : pool) {
+        t.join();
+    }
+}
+
+#endif
@@ -140,6 +140,13 @@ void Data::createRealGraph(const std::string& edges, const std::string& nodes) {
 
         nodesFile.close();
         edgesFile.close();
+
+        // the contraction hierarchy is kept next to the edges file, so it is only built the first time the graph is loaded,
+        // and only for sparse graphs, since contracting a dense one would take far longer than the shortest paths menu
+        std::string hierarchyFile = edges.substr(0, edges.find_last_of('/') + 1) + "hierarchy.csv";
+        if (graph.isSparse() && !graph.loadHierarchy(hierarchyFile) && graph.buildHierarchy()) {
+            graph.saveHierarchy(hierarchyFile);
+        }
 }
 
 Graph *Data::getGraph() {
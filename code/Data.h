@@ -51,10 +51,14 @@ public:
     * This function reads two files containing information about edges and nodes and creates a real-sized graph based on that information.
     * The edges file format should have each line representing an edge in the format "origin, destination, distance".
     * The nodes file format should have each line representing a node in the format "id, longitude, latitude".
+    * If the graph is sparse (see Graph::isSparse), its contraction hierarchy is loaded from hierarchy.csv, next to the edges
+    * file, or built and saved there the first time or when the edges changed, so the distances between vertices not joined
+    * by an edge are shortest path distances. Dense graphs keep the haversine distances until the shortest paths menu is used.
      *
     * @param edges The name of the file containing edge information.
     * @param nodes The name of the file containing node information.
-    * @complexity The time complexity of this function is O(E + N), where E is the number of edges and N is the number of nodes in the files.
+    * @complexity The time complexity of this function is O(E + N), where E is the number of edges and N is the number of nodes in the files,
+    * plus the contraction the first time the graph is loaded.
     */
     void createRealGraph(const std::string& edges, const std::string& nodes);
 
@@ -0,0 +1,312 @@
+#include "DynamicTour.h"
+
+#define EPSILON 1e-7
+
+DynamicTour::DynamicTour(Graph *graph, const std::vector<int> &order): graph(graph) {
+    // the arrays and the k-d tree are indexed by vertex number, which is the ID itself when the IDs are 0 to |V| - 1
+    std::vector<Vertex *> vertices;
+    for (auto &v : graph->getVertexSet()) {
+        vertices.push_back(v.second);
+    }
+    std::sort(vertices.begin(), vertices.end(), [](Vertex *a, Vertex *b) {
+        return a->getId() < b->getId();
+    });
+    int n = vertices.size();
+    for (int v = 0; v < n; v++) {
+        ids.push_back(vertices[v]->getId());
+        index[ids[v]] = v;
+    }
+
+    position.assign(n, -1);
+    queued.assign(n, false);
+    for (int id : order) {
+        int v = numberOf(id);
+        if (v >= 0 && position[v] < 0) {
+            position[v] = this->order.size();
+            this->order.push_back(v);
+        }
+    }
+    int m = this->order.size();
+    for (int i = 0; i < m && m > 1; i++) {
+        length += distance(this->order[i], this->order[(i + 1) % m]);
+    }
+
+    // the k-d tree is only useful if the vertices are spread over the plane
+    bool spread = false;
+    double meanLat = 0;
+    for (int v = 0; v < n; v++) {
+        meanLat += vertices[v]->getLat();
+        spread = spread || vertices[v]->getLat() != vertices[0]->getLat() || vertices[v]->getLong() != vertices[0]->getLong();
+    }
+    if (!spread) {
+        return;
+    }
+
+    double scale = std::cos(meanLat / n * M_PI / 180.0);
+    points.resize(n);
+    for (int v = 0; v < n; v++) {
+        points[v] = {vertices[v]->getLong() * scale, vertices[v]->getLat()};
+    }
+    stops.reset(new KdTree(points));
+    for (int v = 0; v < n; v++) {
+        if (position[v] < 0) stops->remove(v);
+    }
+}
+
+int DynamicTour::numberOf(int id) const {
+    auto it = index.find(id);
+    return it == index.end() ? -1 : it->second;
+}
+
+bool DynamicTour::contains(int v) const {
+    v = numberOf(v);
+    return v >= 0 && position[v] >= 0;
+}
+
+int DynamicTour::size() const {
+    return order.size();
+}
+
+double DynamicTour::getLength() const {
+    return length;
+}
+
+std::vector<int> DynamicTour::getOrder() const {
+    std::vector<int> result;
+    result.reserve(order.size());
+    for (int v : order) {
+        result.push_back(ids[v]);
+    }
+    return result;
+}
+
+std::vector<int> DynamicTour::getPath() const {
+    std::vector<int> path = getOrder();
+    if (!path.empty()) {
+        path.push_back(path.front());
+    }
+    return path;
+}
+
+double DynamicTour::distance(int u, int v) const {
+    return graph->getDistance(ids[u], ids[v]);
+}
+
+int DynamicTour::next(int c) const {
+    int p = position[c] + 1;
+    return order[p == (int) order.size() ? 0 : p];
+}
+
+int DynamicTour::prev(int c) const {
+    int p = position[c];
+    return order[p == 0 ? order.size() - 1 : p - 1];
+}
+
+std::vector<int> DynamicTour::closestStops(int v, int k) const {
+    std::vector<int> result;
+    if (stops != nullptr) {
+        for (int w : stops->nearest(points[v].first, points[v].second, k + 1)) {
+            if (w != v && (int) result.size() < k) result.push_back(w);
+        }
+        return result;
+    }
+
+    std::vector<std::pair<double, int>> all;
+    for (int w : order) {
+        if (w != v) all.push_back({distance(v, w), w});
+    }
+    auto middle = all.begin() + std::min((int) all.size(), k);
+    std::partial_sort(all.begin(), middle, all.end());
+    for (auto it = all.begin(); it != middle; it++) {
+        result.push_back(it->second);
+    }
+    return result;
+}
+
+void DynamicTour::renumber(int from) {
+    for (int i = from; i < (int) order.size(); i++) {
+        position[order[i]] = i;
+    }
+}
+
+void DynamicTour::activate(int c) {
+    if (!queued[c]) {
+        queued[c] = true;
+        active.push_back(c);
+    }
+}
+
+void DynamicTour::reverse(int a, int b) {
+    int m = order.size();
+    int i = position[a], j = position[b];
+    int count = (j - i + m) % m + 1;
+    if (2 * count > m) {
+        // reversing the rest of the tour gives the same cycle
+        i = (j + 1) % m;
+        j = (position[a] - 1 + m) % m;
+        count = m - count;
+    }
+    for (int s = 0; s < count / 2; s++) {
+        std::swap(order[i], order[j]);
+        position[order[i]] = i;
+        position[order[j]] = j;
+        i = i + 1 == m ? 0 : i + 1;
+        j = j == 0 ? m - 1 : j - 1;
+    }
+}
+
+bool DynamicTour::improveTwoOpt(int a) {
+    for (int c : closestStops(a, DYNAMIC_TOUR_CANDIDATES)) {
+        // {a, next(a)} and {c, next(c)} become {a, c} and {next(a), next(c)}
+        int an = next(a), cn = next(c);
+        if (c != an && cn != a) {
+            double gain = distance(a, an) + distance(c, cn) - distance(a, c) - distance(an, cn);
+            if (gain > EPSILON) {
+                reverse(an, c);
+                length -= gain;
+                activate(a); activate(an); activate(c); activate(cn);
+                return true;
+            }
+        }
+
+        // {prev(a), a} and {prev(c), c} become {a, c} and {prev(a), prev(c)}
+        int ap = prev(a), cp = prev(c);
+        if (c != ap && cp != a) {
+            double gain = distance(ap, a) + distance(cp, c) - distance(a, c) - distance(ap, cp);
+            if (gain > EPSILON) {
+                reverse(a, cp);
+                length -= gain;
+                activate(a); activate(ap); activate(c); activate(cp);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool DynamicTour::improveOrOpt(int a) {
+    int m = order.size();
+    int last = a;
+    for (int segment = 1; segment <= 3 && segment + 2 < m; segment++, last = next(last)) {
+        int p = prev(a), q = next(last);
+        double removeGain = distance(p, a) + distance(last, q) - distance(p, q);
+
+        for (int c : closestStops(a, DYNAMIC_TOUR_CANDIDATES)) {
+            // the segment a..last goes between c and next(c), in the orientation that costs less
+            int cn = next(c);
+            bool inside = false;
+            for (int s = a; ; s = next(s)) {
+                inside = inside || s == c || s == cn;
+                if (s == last) break;
+            }
+            if (inside || c == p) continue;
+
+            double forward = distance(c, a) + distance(last, cn);
+            double backward = distance(c, last) + distance(a, cn);
+            double gain = removeGain - std::min(forward, backward) + distance(c, cn);
+            if (gain <= EPSILON) continue;
+
+            std::vector<int> moved;
+            for (int s = a; ; s = next(s)) {
+                moved.push_back(s);
+                if (s == last) break;
+            }
+            if (backward < forward) {
+                std::reverse(moved.begin(), moved.end());
+            }
+
+            // rotate the segment to the end of the array, drop it and put it back after c
+            std::rotate(order.begin(), order.begin() + (position[last] + 1) % m, order.end());
+            order.resize(m - segment);
+            renumber(0);
+            order.insert(order.begin() + position[c] + 1, moved.begin(), moved.end());
+            renumber(0);
+
+            length -= gain;
+            activate(p); activate(q); activate(c); activate(cn); activate(a); activate(last);
+            return true;
+        }
+    }
+    return false;
+}
+
+void DynamicTour::repair() {
+    int moves = 0;
+    while (!active.empty()) {
+        int a = active.front();
+        active.pop_front();
+        queued[a] = false;
+        if (position[a] < 0 || order.size() < 5 || moves >= DYNAMIC_TOUR_MAX_MOVES) continue;
+
+        if (improveTwoOpt(a) || improveOrOpt(a)) {
+            moves++;
+            activate(a);
+        }
+    }
+}
+
+bool DynamicTour::insert(int v) {
+    v = numberOf(v);
+    if (v < 0 || position[v] >= 0) {
+        return false;
+    }
+
+    int m = order.size();
+    if (m < 2) {
+        length = m == 0 ? 0 : 2 * distance(order[0], v);
+        position[v] = m;
+        order.push_back(v);
+        if (stops != nullptr) stops->restore(v);
+        return true;
+    }
+
+    // the cheapest edge next to one of the closest stops
+    int best = -1;
+    double bestCost = INF;
+    for (int c : closestStops(v, DYNAMIC_TOUR_CANDIDATES)) {
+        for (int u : {c, prev(c)}) {
+            double cost = distance(u, v) + distance(v, next(u)) - distance(u, next(u));
+            if (cost < bestCost) {
+                bestCost = cost;
+                best = u;
+            }
+        }
+    }
+
+    int at = position[best] + 1;
+    order.insert(order.begin() + at, v);
+    renumber(at);
+    length += bestCost;
+    if (stops != nullptr) stops->restore(v);
+
+    activate(prev(v)); activate(v); activate(next(v));
+    repair();
+    return true;
+}
+
+bool DynamicTour::remove(int v) {
+    if (!contains(v)) {
+        return false;
+    }
+    v = numberOf(v);
+
+    int m = order.size();
+    int p = prev(v), q = next(v);
+    if (m <= 2) {
+        length = 0;
+    } else {
+        length += distance(p, q) - distance(p, v) - distance(v, q);
+    }
+
+    int at = position[v];
+    order.erase(order.begin() + at);
+    position[v] = -1;
+    renumber(at);
+    if (stops != nullptr) stops->remove(v);
+
+    if (m > 2) {
+        activate(p); activate(q);
+        repair();
+    }
+    return true;
+}
@@ -0,0 +1,139 @@
+#ifndef ROUTING_ALGORITHM_DYNAMIC_TOUR_H
+#define ROUTING_ALGORITHM_DYNAMIC_TOUR_H
+
+/**
+* @file DynamicTour.h
+* @brief Contains the declaration of the DynamicTour class.
+* @author Luiz, Pedro e Raphael
+* @date 02/06/2023
+*/
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <unordered_map>
+#include <algorithm>
+#include <cmath>
+
+#include "data_structures/Graph.h"
+#include "data_structures/KdTree.h"
+
+#define DYNAMIC_TOUR_CANDIDATES 10
+#define DYNAMIC_TOUR_MAX_MOVES 100
+
+/**
+ * @class DynamicTour
+ * @brief A tour over a changing set of vertices (stops) of a graph, repaired locally when a stop is added or removed.
+ *
+ * A new stop is inserted where it lengthens the tour the least, among the edges of its DYNAMIC_TOUR_CANDIDATES closest
+ * stops, and a removed stop is spliced out by joining its two neighbours. Either change is followed by 2-opt + Or-opt
+ * moves that start from the stops around it and stop after DYNAMIC_TOUR_MAX_MOVES improvements, so the rest of the tour
+ * is never looked at. On graphs with coordinates the closest stops come from a k-d tree of the vertices of the graph
+ * that only keeps the stops, otherwise every stop is checked.
+ *
+ * The vertices are numbered 0 to |V| - 1 by increasing ID, so the graph may have any IDs. The stops are kept in an array
+ * in tour order with the position of every vertex, so the tour is never rebuilt: an update moves at most the whole array
+ * once per move, a few microseconds for 10000 stops.
+ */
+class DynamicTour {
+public:
+    /**
+    * @brief Constructs a DynamicTour object over a graph.
+    * @param graph The graph.
+    * @param order The IDs of the initial stops in tour order, without repeating the first one at the end. IDs that are not in
+    * the graph and repeated IDs are skipped, as insert would refuse them.
+    * @complexity O(|V| log |V|) to number the vertices and build the k-d tree.
+    */
+    DynamicTour(Graph *graph, const std::vector<int> &order);
+
+    /**
+    * @brief Adds a stop at its cheapest position and improves the tour around it.
+    * @param v The ID of the vertex.
+    * @return False if the vertex is not in the graph or is already a stop.
+    * @complexity O(k log |V| + m) with coordinates and O(m) lookups without, per move, where m is the number of stops.
+    */
+    bool insert(int v);
+
+    /**
+    * @brief Removes a stop by joining its neighbours and improves the tour around the gap.
+    * @param v The ID of the vertex.
+    * @return False if the vertex is not a stop.
+    * @complexity O(m) per move, where m is the number of stops.
+    */
+    bool remove(int v);
+
+    /**
+    * @brief Checks if a vertex is a stop.
+    */
+    bool contains(int v) const;
+
+    /**
+    * @brief Returns the number of stops.
+    */
+    int size() const;
+
+    /**
+    * @brief Returns the length of the tour, kept up to date by every change.
+    */
+    double getLength() const;
+
+    /**
+    * @brief Returns the IDs of the stops in tour order.
+    */
+    std::vector<int> getOrder() const;
+
+    /**
+    * @brief Returns the closed path of the tour, starting and ending at the first stop.
+    */
+    std::vector<int> getPath() const;
+
+private:
+    Graph *graph;
+    std::unordered_map<int, int> index; // number of every vertex ID
+    std::vector<int> ids;               // ID of every vertex number
+    std::vector<int> order;             // numbers of the stops, in tour order
+    std::vector<int> position;          // position of every vertex number in order, or -1 if it is not a stop
+    double length = 0;
+
+    std::unique_ptr<KdTree> stops;      // only built if the vertices have coordinates, indexed by vertex number
+    std::vector<std::pair<double, double>> points;
+
+    std::deque<int> active;
+    std::vector<bool> queued;
+
+    /**
+    * @brief Returns the number of a vertex ID, or -1 if it is not in the graph.
+    */
+    int numberOf(int id) const;
+
+    double distance(int u, int v) const;
+    int next(int c) const;
+    int prev(int c) const;
+
+    /**
+    * @brief Returns the stops closest to v, not including v itself.
+    */
+    std::vector<int> closestStops(int v, int k) const;
+
+    /**
+    * @brief Updates the positions of the stops from the given index to the end of the array.
+    */
+    void renumber(int from);
+
+    void activate(int c);
+
+    /**
+    * @brief Reverses the path from a to b, following next, or the rest of the tour if it is shorter.
+    */
+    void reverse(int a, int b);
+
+    bool improveTwoOpt(int a);
+    bool improveOrOpt(int a);
+
+    /**
+    * @brief Runs the moves from the active stops until none improves or DYNAMIC_TOUR_MAX_MOVES moves were applied.
+    */
+    void repair();
+};
+
+#endif
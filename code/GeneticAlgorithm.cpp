@@ -0,0 +1,351 @@
+#include "GeneticAlgorithm.h"
+
+#define EPSILON 1e-7
+
+GeneticAlgorithm::GeneticAlgorithm(const DistanceView &view, unsigned int islands, unsigned int seed):
+    view(view), neighbors(view.nearestNeighbors(10)), islands(islands), seed(seed) {
+    if (this->islands == 0) {
+        this->islands = std::max(1u, std::thread::hardware_concurrency());
+    }
+}
+
+unsigned long long GeneticAlgorithm::getGenerations() const {
+    return generations;
+}
+
+unsigned int GeneticAlgorithm::getIslands() const {
+    return islands;
+}
+
+void GeneticAlgorithm::relink(Individual &individual, int c, int from, int to) {
+    if (individual.link[c][0] == from) {
+        individual.link[c][0] = to;
+    } else {
+        individual.link[c][1] = to;
+    }
+}
+
+GeneticAlgorithm::Individual GeneticAlgorithm::toIndividual(const Tour &tour) const {
+    Individual individual;
+    individual.link.resize(tour.size());
+    for (int c = 0; c < tour.size(); c++) {
+        individual.link[c] = {tour.prev(c), tour.next(c)};
+    }
+    individual.length = view.tourLength(tour);
+    return individual;
+}
+
+Tour GeneticAlgorithm::toTour(const Individual &individual) const {
+    int n = individual.link.size();
+    std::vector<int> order;
+    order.reserve(n);
+
+    int prev = individual.link[0][0], c = 0;
+    for (int i = 0; i < n; i++) {
+        order.push_back(c);
+        int next = individual.link[c][0] == prev ? individual.link[c][1] : individual.link[c][0];
+        prev = c;
+        c = next;
+    }
+    return Tour(order);
+}
+
+GeneticAlgorithm::Individual GeneticAlgorithm::randomIndividual(const Tour &seed, LocalSearch &localSearch, std::mt19937 &rng) const {
+    Tour tour = seed;
+    int n = tour.size();
+    std::uniform_int_distribution<int> city(0, n - 1);
+    std::uniform_int_distribution<int> length(1, std::min(50, n / 2));
+
+    for (int i = 0; i < n / 10 + 1; i++) {
+        int a = city(rng), b = a;
+        for (int k = length(rng); k > 0; k--) {
+            b = tour.next(b);
+        }
+        tour.flip(a, b);
+    }
+
+    localSearch.optimize(tour);
+    return toIndividual(tour);
+}
+
+std::vector<std::vector<int>> GeneticAlgorithm::abCycles(const Individual &a, const Individual &b, std::mt19937 &rng) const {
+    int n = a.link.size();
+    auto has = [](const Individual &t, int u, int v) {
+        return t.link[u][0] == v || t.link[u][1] == v;
+    };
+
+    // edges[0] holds the edges of A that are not in B and edges[1] the edges of B that are not in A
+    std::vector<std::array<int, 2>> edges[2] = {std::vector<std::array<int, 2>>(n), std::vector<std::array<int, 2>>(n)};
+    std::vector<int> count[2] = {std::vector<int>(n, 0), std::vector<int>(n, 0)};
+    for (int u = 0; u < n; u++) {
+        for (int k = 0; k < 2; k++) {
+            if (!has(b, u, a.link[u][k])) edges[0][u][count[0][u]++] = a.link[u][k];
+            if (!has(a, u, b.link[u][k])) edges[1][u][count[1][u]++] = b.link[u][k];
+        }
+    }
+
+    auto removeEdge = [&](int type, int u, int v) {
+        for (int k = 0; k < count[type][u]; k++) {
+            if (edges[type][u][k] == v) {
+                edges[type][u][k] = edges[type][u][--count[type][u]];
+                return;
+            }
+        }
+    };
+
+    std::vector<int> starts(n);
+    for (int i = 0; i < n; i++) starts[i] = i;
+    std::shuffle(starts.begin(), starts.end(), rng);
+
+    // position of every city in the path, for each parity; a city never appears twice with the same parity,
+    // because that closes an AB-cycle which is removed from the path
+    std::vector<std::array<int, 2>> position(n, {-1, -1});
+    std::vector<std::vector<int>> cycles;
+    std::vector<int> path;
+
+    for (int s : starts) {
+        if (count[0][s] == 0) continue;
+        path.assign(1, s);
+        position[s][0] = 0;
+
+        while (true) {
+            int k = path.size() - 1;
+            int type = k % 2;
+            int cur = path[k];
+            if (count[type][cur] == 0) {
+                break;
+            }
+
+            int w = edges[type][cur][count[type][cur] == 1 ? 0 : rng() % 2];
+            removeEdge(type, cur, w);
+            removeEdge(type, w, cur);
+            path.push_back(w);
+            k++;
+
+            int i = position[w][k % 2];
+            if (i < 0) {
+                position[w][k % 2] = k;
+                continue;
+            }
+
+            std::vector<int> cycle(path.begin() + i, path.begin() + k);
+            if (i % 2 == 1) {
+                std::rotate(cycle.begin(), cycle.begin() + 1, cycle.end());
+            }
+            cycles.push_back(cycle);
+
+            for (int t = i + 1; t <= k; t++) {
+                position[path[t]][t % 2] = -1;
+            }
+            position[w][k % 2] = i;
+            path.resize(i + 1);
+        }
+        for (unsigned int t = 0; t < path.size(); t++) {
+            position[path[t]][t % 2] = -1;
+        }
+    }
+
+    return cycles;
+}
+
+void GeneticAlgorithm::applyCycle(Individual &child, const std::vector<int> &cycle) const {
+    int n = child.link.size();
+    int m = cycle.size();
+
+    for (int j = 0; j < m; j += 2) {
+        int u = cycle[j], v = cycle[j + 1];
+        relink(child, u, v, -1);
+        relink(child, v, u, -1);
+        child.length -= view.distance(u, v);
+    }
+    for (int j = 1; j < m; j += 2) {
+        int u = cycle[j], v = cycle[(j + 1) % m];
+        relink(child, u, -1, v);
+        relink(child, v, -1, u);
+        child.length += view.distance(u, v);
+    }
+
+    std::vector<int> label(n, -1);
+    std::vector<std::vector<int>> subtours;
+    for (int c = 0; c < n; c++) {
+        if (label[c] >= 0) continue;
+        subtours.emplace_back();
+        int prev = child.link[c][0], cur = c;
+        do {
+            label[cur] = subtours.size() - 1;
+            subtours.back().push_back(cur);
+            int next = child.link[cur][0] == prev ? child.link[cur][1] : child.link[cur][0];
+            prev = cur;
+            cur = next;
+        } while (cur != c);
+    }
+
+    int remaining = subtours.size();
+    while (remaining > 1) {
+        int s = -1;
+        for (unsigned int t = 0; t < subtours.size(); t++) {
+            if (!subtours[t].empty() && (s < 0 || subtours[t].size() < subtours[s].size())) s = t;
+        }
+
+        double bestCost = INF;
+        int bu = -1, bu2 = -1, bv = -1, bv2 = -1;
+        auto consider = [&](int u, int u2, int v) {
+            for (int v2 : child.link[v]) {
+                double cost = view.distance(u, v) + view.distance(u2, v2) - view.distance(u, u2) - view.distance(v, v2);
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    bu = u; bu2 = u2; bv = v; bv2 = v2;
+                }
+            }
+        };
+
+        for (int u : subtours[s]) {
+            for (int u2 : child.link[u]) {
+                for (int v : neighbors[u]) {
+                    if (label[v] != s) consider(u, u2, v);
+                }
+            }
+        }
+        if (bu < 0) {
+            for (int u : subtours[s]) {
+                for (int u2 : child.link[u]) {
+                    for (int v = 0; v < n; v++) {
+                        if (label[v] != s) consider(u, u2, v);
+                    }
+                }
+            }
+        }
+
+        relink(child, bu, bu2, bv);
+        relink(child, bu2, bu, bv2);
+        relink(child, bv, bv2, bu);
+        relink(child, bv2, bv, bu2);
+        child.length += bestCost;
+
+        int t = label[bv];
+        for (int c : subtours[s]) {
+            label[c] = t;
+            subtours[t].push_back(c);
+        }
+        subtours[s].clear();
+        remaining--;
+    }
+}
+
+void GeneticAlgorithm::evolve(unsigned int id, const std::vector<Tour> &seeds, std::chrono::steady_clock::time_point deadline) {
+    std::mt19937 rng(seed * 7919 + id);
+    LocalSearch localSearch(view, neighbors);
+
+    std::vector<Individual> population;
+    for (int i = 0; i < GA_POPULATION && std::chrono::steady_clock::now() < deadline; i++) {
+        population.push_back(randomIndividual(seeds[(id + i) % seeds.size()], localSearch, rng));
+    }
+    if (population.empty()) {
+        return;
+    }
+
+    auto shorter = [](const Individual &a, const Individual &b) {
+        return a.length < b.length;
+    };
+    Individual islandBest = *std::min_element(population.begin(), population.end(), shorter);
+
+    unsigned long long generation = 0;
+    int stagnation = 0;
+    std::vector<int> order(population.size());
+    for (unsigned int i = 0; i < order.size(); i++) order[i] = i;
+
+    while (std::chrono::steady_clock::now() < deadline) {
+        {
+            std::lock_guard<std::mutex> lock(inboxes[id]->mutex);
+            for (auto &immigrant : inboxes[id]->individuals) {
+                auto worst = std::max_element(population.begin(), population.end(), shorter);
+                if (immigrant.length < worst->length - EPSILON) {
+                    *worst = std::move(immigrant);
+                }
+            }
+            inboxes[id]->individuals.clear();
+        }
+
+        bool improved = false;
+        std::shuffle(order.begin(), order.end(), rng);
+        for (unsigned int i = 0; i < order.size() && std::chrono::steady_clock::now() < deadline; i++) {
+            Individual &a = population[order[i]];
+            const Individual &b = population[order[(i + 1) % order.size()]];
+
+            std::vector<std::vector<int>> cycles = abCycles(a, b, rng);
+            std::shuffle(cycles.begin(), cycles.end(), rng);
+
+            Individual bestChild;
+            bestChild.length = INF;
+            for (unsigned int c = 0; c < cycles.size() && c < GA_CHILDREN; c++) {
+                Individual child = a;
+                applyCycle(child, cycles[c]);
+                if (child.length < bestChild.length) {
+                    bestChild = std::move(child);
+                }
+            }
+
+            if (bestChild.length < a.length - EPSILON) {
+                a = std::move(bestChild);
+                if (a.length < islandBest.length - EPSILON) {
+                    islandBest = a;
+                    improved = true;
+                }
+            }
+        }
+
+        generation++;
+        stagnation = improved ? 0 : stagnation + 1;
+
+        if (stagnation >= GA_STAGNATION_GENERATIONS) {
+            Tour tour = toTour(islandBest);
+            for (auto &individual : population) {
+                if (std::chrono::steady_clock::now() >= deadline) break;
+                individual = randomIndividual(tour, localSearch, rng);
+            }
+            population[0] = islandBest;
+            stagnation = 0;
+        }
+
+        if (generation % GA_MIGRATION_GENERATIONS == 0 && islands > 1) {
+            std::lock_guard<std::mutex> lock(inboxes[(id + 1) % islands]->mutex);
+            inboxes[(id + 1) % islands]->individuals.push_back(islandBest);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (best.link.empty() || islandBest.length < best.length) {
+        best = islandBest;
+    }
+    generations += generation;
+}
+
+double GeneticAlgorithm::optimize(const std::vector<Tour> &seeds, Tour &best, double timeLimit) {
+    generations = 0;
+    best = *std::min_element(seeds.begin(), seeds.end(), [this](const Tour &a, const Tour &b) {
+        return view.tourLength(a) < view.tourLength(b);
+    });
+    if (best.size() < 8) {
+        return view.tourLength(best);
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(timeLimit));
+
+    this->best = toIndividual(best);
+    inboxes.clear();
+    for (unsigned int id = 0; id < islands; id++) {
+        inboxes.emplace_back(new Inbox());
+    }
+
+    std::vector<std::thread> pool;
+    for (unsigned int id = 0; id < islands; id++) {
+        pool.emplace_back(&GeneticAlgorithm::evolve, this, id, std::cref(seeds), deadline);
+    }
+    for (auto &t : pool) {
+        t.join();
+    }
+
+    best = toTour(this->best);
+    return view.tourLength(best);
+}
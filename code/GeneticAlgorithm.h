@@ -0,0 +1,138 @@
+#ifndef ROUTING_ALGORITHM_GENETIC_ALGORITHM_H
+#define ROUTING_ALGORITHM_GENETIC_ALGORITHM_H
+
+/**
+* @file GeneticAlgorithm.h
+* @brief Contains the declaration of the GeneticAlgorithm class.
+* @author Luiz, Pedro e Raphael
+* @date 02/06/2023
+*/
+
+#include <vector>
+#include <array>
+#include <random>
+#include <thread>
+#include <mutex>
+#include <memory>
+#include <chrono>
+#include <algorithm>
+
+#include "data_structures/DistanceView.h"
+#include "data_structures/Tour.h"
+#include "LocalSearch.h"
+
+#define GA_SEEDS 8
+#define GA_POPULATION 30
+#define GA_CHILDREN 30
+#define GA_MIGRATION_GENERATIONS 10
+#define GA_STAGNATION_GENERATIONS 30
+
+/**
+ * @class GeneticAlgorithm
+ * @brief Island-model genetic algorithm with edge assembly crossover (EAX).
+ *
+ * Every island runs on its own thread with a population of GA_POPULATION tours. In each generation the population is
+ * shuffled and every tour A is crossed with the next tour B: the union of their edges is decomposed into AB-cycles
+ * (cycles alternating edges of A and B), and each child replaces the A edges of one AB-cycle by its B edges and
+ * reconnects the resulting sub-tours with the cheapest 2-opt style merges. The best of up to GA_CHILDREN children
+ * replaces A if it is shorter, so the children inherit almost all their edges from the parents.
+ *
+ * Every GA_MIGRATION_GENERATIONS generations each island sends its best tour to the next island, which replaces its worst
+ * tour. An island that does not improve for GA_STAGNATION_GENERATIONS generations keeps its best tour and is reseeded.
+ */
+class GeneticAlgorithm {
+public:
+    /**
+    * @brief Constructs a GeneticAlgorithm object and computes the candidate lists shared by the islands.
+    * @param view The distances between the cities.
+    * @param islands The number of islands (one thread each), or 0 to use one per hardware thread.
+    * @param seed The seed of the random number generators.
+    * @complexity O(n^2) on dense views, see DistanceView::nearestNeighbors.
+    */
+    GeneticAlgorithm(const DistanceView &view, unsigned int islands = 0, unsigned int seed = 0);
+
+    /**
+    * @brief Evolves the islands until the time limit is reached.
+    *
+    * Each island starts from the seed tours, randomly perturbed and improved with 2-opt + Or-opt.
+    *
+    * @param seeds The initial tours, for example from the construction heuristics. Must not be empty.
+    * @param best[out] The best tour found.
+    * @param timeLimit The wall-clock budget in seconds.
+    * @return The length of the best tour found.
+    * @complexity Bounded by the time limit; each child costs O(n).
+    */
+    double optimize(const std::vector<Tour> &seeds, Tour &best, double timeLimit);
+
+    /**
+    * @brief Returns the number of generations run by all islands in the last call to optimize().
+    */
+    unsigned long long getGenerations() const;
+
+    /**
+    * @brief Returns the number of islands used.
+    */
+    unsigned int getIslands() const;
+
+private:
+    /**
+    * @brief A tour stored as the two neighbours of every city, which is the representation EAX works on.
+    */
+    struct Individual {
+        std::vector<std::array<int, 2>> link;
+        double length = 0;
+    };
+
+    /**
+    * @brief The individuals migrating to an island.
+    */
+    struct Inbox {
+        std::mutex mutex;
+        std::vector<Individual> individuals;
+    };
+
+    const DistanceView &view;
+    std::vector<std::vector<int>> neighbors;
+    unsigned int islands;
+    unsigned int seed;
+
+    std::vector<std::unique_ptr<Inbox>> inboxes;
+    std::mutex mutex;
+    Individual best;
+    unsigned long long generations = 0;
+
+    /**
+    * @brief Runs one island until the deadline.
+    */
+    void evolve(unsigned int id, const std::vector<Tour> &seeds, std::chrono::steady_clock::time_point deadline);
+
+    /**
+    * @brief Creates a random individual from a seed: reverses random short segments and applies 2-opt + Or-opt.
+    */
+    Individual randomIndividual(const Tour &seed, LocalSearch &localSearch, std::mt19937 &rng) const;
+
+    Individual toIndividual(const Tour &tour) const;
+    Tour toTour(const Individual &individual) const;
+
+    /**
+    * @brief Decomposes the edges of A and B that are not common to both into AB-cycles.
+    * @return Every AB-cycle as its list of cities c0 c1 ... c2m-1, where {c0, c1} is an edge of A, {c1, c2} of B, and so on.
+    * @complexity O(n)
+    */
+    std::vector<std::vector<int>> abCycles(const Individual &a, const Individual &b, std::mt19937 &rng) const;
+
+    /**
+    * @brief Replaces the A edges of an AB-cycle by its B edges and merges the resulting sub-tours into a single tour.
+    * @param child A copy of A, which becomes the child.
+    * @param cycle The AB-cycle.
+    * @complexity O(n) plus the merges, which only look at the candidate lists of the smallest sub-tour.
+    */
+    void applyCycle(Individual &child, const std::vector<int> &cycle) const;
+
+    /**
+    * @brief Replaces the neighbour from of city c by to.
+    */
+    static void relink(Individual &individual, int c, int from, int to);
+};
+
+#endif
@@ -0,0 +1,203 @@
+#include "HeldKarp.h"
+
+#define EPSILON 1e-7
+
+HeldKarp::HeldKarp(const DistanceView &view, unsigned int threads): view(view), threads(threads) {
+    if (this->threads == 0) {
+        this->threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+}
+
+const std::vector<double> &HeldKarp::getPi() const {
+    return bestPi;
+}
+
+double HeldKarp::cost(const std::vector<double> &pi, int i, int j) const {
+    return view.distance(i, j) + pi[i] + pi[j];
+}
+
+void HeldKarp::oneTree(const std::vector<double> &pi, OneTree &tree, std::vector<double> &key, std::vector<bool> &inTree) const {
+    int n = view.size();
+    tree.cost = 0;
+    tree.degree.assign(n, 0);
+    tree.parent.assign(n, -1);
+    tree.weight.assign(n, 0);
+    tree.order.clear();
+    std::fill(key.begin(), key.end(), INF);
+    std::fill(inTree.begin(), inTree.end(), false);
+
+    // dense Prim over the cities 1 to n - 1
+    int v = 1;
+    key[v] = 0;
+    for (int step = 1; step < n; step++) {
+        inTree[v] = true;
+        tree.order.push_back(v);
+        tree.cost += key[v];
+        if (tree.parent[v] >= 0) {
+            tree.degree[v]++;
+            tree.degree[tree.parent[v]]++;
+        }
+
+        int next = -1;
+        for (int w = 1; w < n; w++) {
+            if (inTree[w]) continue;
+            double c = cost(pi, v, w);
+            if (c < key[w]) {
+                key[w] = c;
+                tree.parent[w] = v;
+                tree.weight[w] = c;
+            }
+            if (next < 0 || key[w] < key[next]) next = w;
+        }
+        v = next;
+    }
+
+    // the two shortest edges of city 0
+    tree.first = tree.second = -1;
+    for (int w = 1; w < n; w++) {
+        if (tree.first < 0 || cost(pi, 0, w) < cost(pi, 0, tree.first)) {
+            tree.second = tree.first;
+            tree.first = w;
+        } else if (tree.second < 0 || cost(pi, 0, w) < cost(pi, 0, tree.second)) {
+            tree.second = w;
+        }
+    }
+    tree.cost += cost(pi, 0, tree.first) + cost(pi, 0, tree.second);
+    tree.degree[0] = 2;
+    tree.degree[tree.first]++;
+    tree.degree[tree.second]++;
+}
+
+void HeldKarp::chain(double lambda, double upperBound, std::chrono::steady_clock::time_point deadline) {
+    int n = view.size();
+    std::vector<double> pi(n, 0), key(n);
+    std::vector<bool> inTree(n);
+    OneTree tree;
+
+    std::vector<double> chainPi(n, 0);
+    double chainBound = -INF;
+    int stalled = 0;
+
+    for (int iteration = 0; iteration < HK_MAX_ITERATIONS && std::chrono::steady_clock::now() < deadline; iteration++) {
+        oneTree(pi, tree, key, inTree);
+        double bound = tree.cost;
+        for (double p : pi) {
+            bound -= 2 * p;
+        }
+
+        if (bound > chainBound + EPSILON) {
+            chainBound = bound;
+            chainPi = pi;
+            stalled = 0;
+        } else if (++stalled == HK_HALVING_PERIOD) {
+            lambda /= 2;
+            stalled = 0;
+        }
+
+        double norm = 0;
+        for (int d : tree.degree) {
+            norm += (d - 2) * (d - 2);
+        }
+        // a 1-tree where every city has degree 2 is a tour, so the bound cannot be raised any further
+        if (norm == 0 || lambda < EPSILON || bound >= upperBound - EPSILON) {
+            break;
+        }
+
+        double step = lambda * (upperBound - bound) / norm;
+        for (int i = 0; i < n; i++) {
+            pi[i] += step * (tree.degree[i] - 2);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (chainBound > bestBound) {
+        bestBound = chainBound;
+        bestPi = chainPi;
+    }
+}
+
+double HeldKarp::lowerBound(double upperBound, double timeLimit) {
+    int n = view.size();
+    bestPi.assign(n, 0);
+    bestBound = 0;
+    if (n < 3) {
+        bestBound = n == 2 ? 2 * view.distance(0, 1) : 0;
+        return bestBound;
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(timeLimit));
+
+    // the chains only differ by their initial step size: 2, 1, 0.5, 0.25 and again
+    std::vector<std::thread> pool;
+    for (unsigned int id = 0; id < threads; id++) {
+        pool.emplace_back(&HeldKarp::chain, this, 2.0 / (1 << (id % 4)), upperBound, deadline);
+    }
+    for (auto &t : pool) {
+        t.join();
+    }
+
+    // a bound above the known tour can only be a rounding error
+    bestBound = std::min(bestBound, upperBound);
+    return bestBound;
+}
+
+std::vector<std::vector<int>> HeldKarp::alphaNearness(int k) const {
+    int n = view.size();
+    std::vector<std::vector<int>> candidates(n);
+    if (n < 3) {
+        return view.nearestNeighbors(k);
+    }
+
+    std::vector<double> pi = bestPi, key(n);
+    pi.resize(n, 0);
+    std::vector<bool> inTree(n);
+    OneTree tree;
+    oneTree(pi, tree, key, inTree);
+
+    // an edge of city 0 has to replace the longer of its two 1-tree edges
+    double secondEdge = cost(pi, 0, tree.second);
+    int root = tree.order.front();
+
+    std::vector<double> beta(n);
+    std::vector<int> mark(n, -1);
+    std::vector<std::pair<double, std::pair<double, int>>> alpha;
+    for (int i = 0; i < n; i++) {
+        alpha.clear();
+
+        if (i == 0) {
+            for (int j = 1; j < n; j++) {
+                double a = j == tree.first || j == tree.second ? 0 : cost(pi, 0, j) - secondEdge;
+                alpha.push_back({a, {view.distance(0, j), j}});
+            }
+        } else {
+            // beta[j] is the longest edge on the tree path from i to j, which the edge {i, j} would replace
+            beta[i] = -INF;
+            for (int c = i; c != root; c = tree.parent[c]) {
+                beta[tree.parent[c]] = std::max(beta[c], tree.weight[c]);
+                mark[tree.parent[c]] = i;
+            }
+            for (int j : tree.order) {
+                if (j != root && j != i && mark[j] != i) {
+                    beta[j] = std::max(beta[tree.parent[j]], tree.weight[j]);
+                }
+            }
+
+            double a0 = i == tree.first || i == tree.second ? 0 : cost(pi, i, 0) - secondEdge;
+            alpha.push_back({a0, {view.distance(i, 0), 0}});
+            for (int j = 1; j < n; j++) {
+                if (j != i) {
+                    alpha.push_back({cost(pi, i, j) - beta[j], {view.distance(i, j), j}});
+                }
+            }
+        }
+
+        auto middle = alpha.begin() + std::min((int) alpha.size(), k);
+        std::partial_sort(alpha.begin(), middle, alpha.end());
+        for (auto it = alpha.begin(); it != middle; it++) {
+            candidates[i].push_back(it->second.second);
+        }
+    }
+
+    return candidates;
+}
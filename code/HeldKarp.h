@@ -0,0 +1,102 @@
+#ifndef ROUTING_ALGORITHM_HELD_KARP_H
+#define ROUTING_ALGORITHM_HELD_KARP_H
+
+/**
+* @file HeldKarp.h
+* @brief Contains the declaration of the HeldKarp class.
+* @author Luiz, Pedro e Raphael
+* @date 02/06/2023
+*/
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <chrono>
+#include <algorithm>
+
+#include "data_structures/DistanceView.h"
+
+#define HK_MAX_ITERATIONS 1000
+#define HK_HALVING_PERIOD 30
+#define HK_ALPHA_CANDIDATES 5
+#define HK_TIME_LIMIT 10
+
+/**
+ * @class HeldKarp
+ * @brief Computes the Held-Karp lower bound of the TSP with subgradient optimization over 1-trees.
+ *
+ * A 1-tree is a minimum spanning tree of the cities 1 to n - 1 plus the two shortest edges of city 0, so every tour is
+ * a 1-tree and the shortest 1-tree is a lower bound. Adding a penalty pi[i] to every edge of city i does not change
+ * which tour is optimal, and the bound of the penalized 1-tree is raised by moving pi towards the cities whose degree
+ * is not 2. Independent chains of the subgradient ascent, with different initial step sizes, run on their own threads
+ * and each recomputes its 1-trees with a dense O(n^2) Prim, so the view should have a distance matrix.
+ */
+class HeldKarp {
+public:
+    /**
+    * @brief Constructs a HeldKarp object.
+    * @param view The distances between the cities.
+    * @param threads The number of chains (one thread each), or 0 to use one per hardware thread.
+    * @complexity O(1)
+    */
+    HeldKarp(const DistanceView &view, unsigned int threads = 0);
+
+    /**
+    * @brief Computes the Held-Karp lower bound.
+    *
+    * @param upperBound The length of a known tour, which sets the step size of the ascent.
+    * @param timeLimit The wall-clock budget in seconds.
+    * @return The best lower bound found, which is at most the length of the shortest tour.
+    * @complexity O(n^2) per iteration, with at most HK_MAX_ITERATIONS iterations per chain.
+    */
+    double lowerBound(double upperBound, double timeLimit);
+
+    /**
+    * @brief Returns the penalties of the best lower bound found.
+    */
+    const std::vector<double> &getPi() const;
+
+    /**
+    * @brief Computes the alpha-nearness candidate lists from the penalties of the best lower bound.
+    *
+    * The alpha-nearness of the edge {i, j} is how much the shortest penalized 1-tree grows when it is forced to contain
+    * the edge. The edges of an optimal tour have small alpha-nearness much more often than they are among the nearest neighbours.
+    *
+    * @param k The maximum number of candidates per city.
+    * @return For every city, its candidates sorted by increasing alpha-nearness.
+    * @complexity O(n^2 + n * k log k)
+    */
+    std::vector<std::vector<int>> alphaNearness(int k) const;
+
+private:
+    const DistanceView &view;
+    unsigned int threads;
+
+    std::mutex mutex;
+    std::vector<double> bestPi;
+    double bestBound = 0;
+
+    /**
+    * @brief The shortest 1-tree with the penalties pi.
+    */
+    struct OneTree {
+        double cost;                // sum of the penalized weights of the edges
+        std::vector<int> degree;
+        std::vector<int> parent;    // parent in the spanning tree of the cities 1 to n - 1, or -1 for its root and for city 0
+        std::vector<int> order;     // the cities 1 to n - 1 in the order they joined the spanning tree
+        std::vector<double> weight; // penalized weight of the edge to the parent
+        int first, second;          // the two cities joined to city 0
+    };
+
+    double cost(const std::vector<double> &pi, int i, int j) const;
+
+    void oneTree(const std::vector<double> &pi, OneTree &tree, std::vector<double> &key, std::vector<bool> &inTree) const;
+
+    /**
+    * @brief Runs one chain of the subgradient ascent until its step size vanishes or the deadline.
+    * @param lambda The initial step size factor, which is halved after HK_HALVING_PERIOD iterations without improvement.
+    */
+    void chain(double lambda, double upperBound, std::chrono::steady_clock::time_point deadline);
+};
+
+#endif
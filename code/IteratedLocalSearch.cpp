@@ -0,0 +1,129 @@
+#include "IteratedLocalSearch.h"
+
+#define EPSILON 1e-7
+
+IteratedLocalSearch::IteratedLocalSearch(const DistanceView &view, unsigned int threads, unsigned int seed):
+    view(view), neighbors(view.nearestNeighbors(10)), threads(threads), seed(seed) {
+    if (this->threads == 0) {
+        this->threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+}
+
+unsigned long long IteratedLocalSearch::getIterations() const {
+    return iterations;
+}
+
+unsigned int IteratedLocalSearch::getThreads() const {
+    return threads;
+}
+
+void IteratedLocalSearch::exchange(Tour &tour, int a1, int a2, int c1, int c2) {
+    if (tour.next(a1) == a2) {
+        tour.flip(a2, c1);
+    } else {
+        tour.flip(a1, c2);
+    }
+}
+
+double IteratedLocalSearch::doubleBridge(Tour &tour, std::mt19937 &rng, std::vector<int> &touched,
+                                         std::vector<std::array<int, 4>> &moves) const {
+    int n = tour.size();
+    int maxSegment = std::min(ILS_MAX_SEGMENT, n / 4);
+
+    // B = b1..b2 and C = c1..c2 follow the city p; C has at least two cities so that D is never adjacent to B
+    int p = std::uniform_int_distribution<int>(0, n - 1)(rng);
+    int lengthB = std::uniform_int_distribution<int>(1, maxSegment)(rng);
+    int lengthC = std::uniform_int_distribution<int>(2, maxSegment)(rng);
+
+    int b1 = tour.next(p), b2 = b1;
+    for (int i = 1; i < lengthB; i++) b2 = tour.next(b2);
+    int c1 = tour.next(b2), c2 = c1;
+    for (int i = 1; i < lengthC; i++) c2 = tour.next(c2);
+    int d1 = tour.next(c2);
+
+    touched.assign({p, b1, b2, c1, c2, d1});
+    moves.clear();
+    moves.push_back({p, b1, c2, d1});
+    moves.push_back({c2, p, b2, c1});
+    moves.push_back({c2, b2, b1, d1});
+    for (auto &m : moves) {
+        exchange(tour, m[0], m[1], m[2], m[3]);
+    }
+
+    return view.distance(p, c1) + view.distance(c2, b1) + view.distance(b2, d1)
+         - view.distance(p, b1) - view.distance(b2, c1) - view.distance(c2, d1);
+}
+
+void IteratedLocalSearch::worker(unsigned int id, std::chrono::steady_clock::time_point deadline) {
+    std::mt19937 rng(seed * 7919 + id);
+    LocalSearch localSearch(view, neighbors);
+    std::vector<int> touched;
+    std::vector<std::array<int, 4>> moves;
+
+    Tour tour;
+    double length;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tour = Tour(bestOrder);
+        length = bestLength;
+    }
+
+    unsigned long long count = 0;
+    while (std::chrono::steady_clock::now() < deadline && (stop == nullptr || !*stop)) {
+        double delta = doubleBridge(tour, rng, touched, moves);
+        double gain = localSearch.improve(tour, touched);
+
+        if (delta - gain < -EPSILON) {
+            length += delta - gain;
+        } else {
+            localSearch.undo();
+            for (auto it = moves.rbegin(); it != moves.rend(); it++) {
+                exchange(tour, (*it)[0], (*it)[2], (*it)[1], (*it)[3]);
+            }
+        }
+
+        if (++count % ILS_SYNC_ITERATIONS == 0) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (length < bestLength - EPSILON) {
+                bestLength = length;
+                bestOrder = tour.toVector(0);
+            } else if (bestLength < length - EPSILON) {
+                tour = Tour(bestOrder);
+                length = bestLength;
+            }
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (length < bestLength - EPSILON) {
+        bestLength = length;
+        bestOrder = tour.toVector(0);
+    }
+    iterations += count;
+}
+
+double IteratedLocalSearch::optimize(Tour &tour, double timeLimit, const std::atomic<bool> *stop) {
+    iterations = 0;
+    this->stop = stop;
+    if (tour.size() < 8) {
+        return view.tourLength(tour);
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(timeLimit));
+
+    LocalSearch localSearch(view, neighbors);
+    bestLength = localSearch.optimize(tour, stop);
+    bestOrder = tour.toVector(0);
+
+    std::vector<std::thread> pool;
+    for (unsigned int id = 0; id < threads; id++) {
+        pool.emplace_back(&IteratedLocalSearch::worker, this, id, deadline);
+    }
+    for (auto &t : pool) {
+        t.join();
+    }
+
+    tour = Tour(bestOrder);
+    return view.tourLength(tour);
+}
@@ -0,0 +1,104 @@
+#ifndef ROUTING_ALGORITHM_ITERATED_LOCAL_SEARCH_H
+#define ROUTING_ALGORITHM_ITERATED_LOCAL_SEARCH_H
+
+/**
+* @file IteratedLocalSearch.h
+* @brief Contains the declaration of the IteratedLocalSearch class.
+* @author Luiz, Pedro e Raphael
+* @date 02/06/2023
+*/
+
+#include <vector>
+#include <random>
+#include <thread>
+#include <mutex>
+#include <chrono>
+#include <algorithm>
+#include <array>
+#include <atomic>
+
+#include "data_structures/DistanceView.h"
+#include "data_structures/Tour.h"
+#include "LocalSearch.h"
+
+#define ILS_MAX_SEGMENT 50
+#define ILS_SYNC_ITERATIONS 256
+
+/**
+ * @class IteratedLocalSearch
+ * @brief Multi-threaded iterated local search with double-bridge kicks.
+ *
+ * Every thread keeps a private copy of the tour and repeatedly applies a random double-bridge move followed by
+ * 2-opt + Or-opt local search from the eight endpoints of the kick. A kick is kept only if the tour got shorter,
+ * otherwise both the local search and the kick are undone. Every ILS_SYNC_ITERATIONS iterations each thread
+ * publishes its tour if it is the best so far and adopts the global best if it is shorter than its own.
+ */
+class IteratedLocalSearch {
+public:
+    /**
+    * @brief Constructs an IteratedLocalSearch object and computes the candidate lists shared by the threads.
+    * @param view The distances between the cities.
+    * @param threads The number of threads, or 0 to use one per hardware thread.
+    * @param seed The seed of the random number generators.
+    * @complexity O(n^2) on dense views, see DistanceView::nearestNeighbors.
+    */
+    IteratedLocalSearch(const DistanceView &view, unsigned int threads = 0, unsigned int seed = 0);
+
+    /**
+    * @brief Improves a tour until the time limit is reached.
+    *
+    * @param tour The initial tour, which is replaced by the best tour found.
+    * @param timeLimit The wall-clock budget in seconds.
+    * @param stop An optional flag that stops the search before the time limit once it is set by another thread.
+    * @return The length of the best tour found.
+    * @complexity Bounded by the time limit; each iteration is proportional to the size of the kick, not of the tour.
+    */
+    double optimize(Tour &tour, double timeLimit, const std::atomic<bool> *stop = nullptr);
+
+    /**
+    * @brief Returns the number of kicks tried by all threads in the last call to optimize().
+    */
+    unsigned long long getIterations() const;
+
+    /**
+    * @brief Returns the number of threads used.
+    */
+    unsigned int getThreads() const;
+
+private:
+    const DistanceView &view;
+    std::vector<std::vector<int>> neighbors;
+    unsigned int threads;
+    unsigned int seed;
+    const std::atomic<bool> *stop = nullptr;
+
+    std::mutex mutex;
+    std::vector<int> bestOrder;
+    double bestLength = 0;
+    unsigned long long iterations = 0;
+
+    /**
+    * @brief Runs the kicks of one thread until the deadline or the stop flag.
+    * @param id The index of the thread, used to seed its random number generator.
+    * @param deadline The moment when the search stops.
+    */
+    void worker(unsigned int id, std::chrono::steady_clock::time_point deadline);
+
+    /**
+    * @brief Applies a random double-bridge move A B C D -> A C B D, with B and C of at most ILS_MAX_SEGMENT cities.
+    *
+    * @param tour The tour.
+    * @param rng The random number generator of the thread.
+    * @param touched[out] The endpoints of the removed edges.
+    * @param moves[out] The 2-opt moves of the kick, see exchange().
+    * @return The increase of the tour length.
+    */
+    double doubleBridge(Tour &tour, std::mt19937 &rng, std::vector<int> &touched, std::vector<std::array<int, 4>> &moves) const;
+
+    /**
+    * @brief Replaces the tour edges {a1, a2} and {c1, c2} by {a1, c1} and {a2, c2}, whatever the orientation of the tour.
+    */
+    static void exchange(Tour &tour, int a1, int a2, int c1, int c2);
+};
+
+#endif
@@ -0,0 +1,228 @@
+#include "KarpPartition.h"
+
+KarpPartition::KarpPartition(Graph *graph, int cellSize, unsigned int threads): graph(graph), view(graph), cellSize(std::max(cellSize, 8)), threads(threads) {
+    if (this->threads == 0) {
+        this->threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    int n = view.size();
+    double meanLat = 0;
+    for (int v = 0; v < n; v++) {
+        meanLat += graph->findVertex(v)->getLat();
+    }
+    double scale = n == 0 ? 1 : std::cos(meanLat / n * M_PI / 180.0);
+
+    for (auto &c : coordinates) {
+        c.resize(n);
+    }
+    cities.resize(n);
+    for (int v = 0; v < n; v++) {
+        coordinates[0][v] = graph->findVertex(v)->getLong() * scale;
+        coordinates[1][v] = graph->findVertex(v)->getLat();
+        cities[v] = v;
+    }
+
+    if (n > 0) {
+        split(0, n);
+    }
+}
+
+int KarpPartition::getNumCells() const {
+    return leaves;
+}
+
+int KarpPartition::split(int lo, int hi) {
+    int index = cells.size();
+    cells.push_back({lo, hi});
+    if (hi - lo <= cellSize) {
+        leaves++;
+        return index;
+    }
+
+    double extent[2];
+    for (int axis = 0; axis < 2; axis++) {
+        auto bounds = std::minmax_element(cities.begin() + lo, cities.begin() + hi, [this, axis](int a, int b) {
+            return coordinates[axis][a] < coordinates[axis][b];
+        });
+        extent[axis] = coordinates[axis][*bounds.second] - coordinates[axis][*bounds.first];
+    }
+    int axis = extent[1] > extent[0] ? 1 : 0;
+
+    int mid = lo + (hi - lo) / 2;
+    std::nth_element(cities.begin() + lo, cities.begin() + mid, cities.begin() + hi, [this, axis](int a, int b) {
+        return coordinates[axis][a] < coordinates[axis][b];
+    });
+
+    // the halves are added after the cell, so cells[index] may move while they are built
+    int left = split(lo, mid);
+    int right = split(mid, hi);
+    cells[index].axis = axis;
+    cells[index].line = coordinates[axis][cities[mid]];
+    cells[index].left = left;
+    cells[index].right = right;
+    return index;
+}
+
+std::vector<int> KarpPartition::solveCell(const Cell &cell) const {
+    std::vector<int> vertices(cities.begin() + cell.lo, cities.begin() + cell.hi);
+    int k = vertices.size();
+    if (k <= 3) {
+        return vertices;
+    }
+
+    // a nearest neighbour tour over the distances of the cell only, improved by Lin-Kernighan
+    DistanceView cellView(graph, vertices, 1);
+    std::vector<bool> visited(k, false);
+    std::vector<int> order;
+    for (int c = 0; c >= 0; ) {
+        visited[c] = true;
+        order.push_back(c);
+        int next = -1;
+        for (int j = 0; j < k; j++) {
+            if (!visited[j] && (next < 0 || cellView.distance(c, j) < cellView.distance(c, next))) {
+                next = j;
+            }
+        }
+        c = next;
+    }
+
+    Tour tour(order);
+    LinKernighan linKernighan(cellView);
+    linKernighan.optimize(tour);
+
+    std::vector<int> result;
+    for (int c : tour.toVector(0)) {
+        result.push_back(cellView.getVertex(c));
+    }
+    return result;
+}
+
+std::vector<int> KarpPartition::closestToLine(const std::vector<int> &order, const Cell &cell) const {
+    std::vector<int> positions(order.size());
+    for (unsigned int p = 0; p < order.size(); p++) {
+        positions[p] = p;
+    }
+
+    auto closer = [&](int p, int q) {
+        return std::abs(coordinates[cell.axis][order[p]] - cell.line) < std::abs(coordinates[cell.axis][order[q]] - cell.line);
+    };
+    if ((int) positions.size() > PARTITION_SEAM_CITIES) {
+        std::nth_element(positions.begin(), positions.begin() + PARTITION_SEAM_CITIES, positions.end(), closer);
+        positions.resize(PARTITION_SEAM_CITIES);
+    }
+    return positions;
+}
+
+std::vector<int> KarpPartition::stitch(const std::vector<int> &a, const std::vector<int> &b, const Cell &cell, std::vector<int> &seams) const {
+    int sizeA = a.size(), sizeB = b.size();
+
+    // the edge e of a tour joins its vertices at positions e and e + 1; both edges of every vertex near the line are tried
+    auto edgesNearLine = [&](const std::vector<int> &order) {
+        int size = order.size();
+        std::vector<int> edges;
+        for (int p : closestToLine(order, cell)) {
+            edges.push_back(p);
+            edges.push_back((p + size - 1) % size);
+        }
+        std::sort(edges.begin(), edges.end());
+        edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+        return edges;
+    };
+    std::vector<int> edgesA = edgesNearLine(a), edgesB = edgesNearLine(b);
+
+    // {a1, a2} and {b1, b2} are replaced by {a1, b1} and {a2, b2} (same) or by {a1, b2} and {a2, b1} (crossed)
+    double best = INF;
+    int bestA = 0, bestB = 0;
+    bool crossed = false;
+    for (int ea : edgesA) {
+        int a1 = a[ea], a2 = a[(ea + 1) % sizeA];
+        double removedA = view.distance(a1, a2);
+        for (int eb : edgesB) {
+            int b1 = b[eb], b2 = b[(eb + 1) % sizeB];
+            double removed = removedA + view.distance(b1, b2);
+            double same = view.distance(a1, b1) + view.distance(a2, b2) - removed;
+            double cross = view.distance(a1, b2) + view.distance(a2, b1) - removed;
+            if (same < best) {
+                best = same;
+                bestA = ea, bestB = eb, crossed = false;
+            }
+            if (cross < best) {
+                best = cross;
+                bestA = ea, bestB = eb, crossed = true;
+            }
+        }
+    }
+
+    // a2 ... a1 around the first tour, then b from the vertex joined to a1 around to the one joined to a2
+    std::vector<int> order;
+    order.reserve(sizeA + sizeB);
+    for (int i = 1; i <= sizeA; i++) {
+        order.push_back(a[(bestA + i) % sizeA]);
+    }
+    for (int i = 0; i < sizeB; i++) {
+        order.push_back(crossed ? b[(bestB + 1 + i) % sizeB] : b[(bestB - i + sizeB) % sizeB]);
+    }
+
+    seams.insert(seams.end(), {a[bestA], a[(bestA + 1) % sizeA], b[bestB], b[(bestB + 1) % sizeB]});
+    return order;
+}
+
+void KarpPartition::parallel(const std::function<void(unsigned int)> &f) const {
+    std::vector<std::thread> pool;
+    for (unsigned int id = 1; id < threads; id++) {
+        pool.emplace_back(f, id);
+    }
+    f(0);
+    for (auto &t : pool) {
+        t.join();
+    }
+}
+
+double KarpPartition::solve(Tour &tour) {
+    int n = view.size();
+    if (n == 0) {
+        tour = Tour();
+        return 0;
+    }
+
+    // the cells are taken one at a time from a shared counter, since their costs differ
+    std::vector<std::vector<int>> tours(cells.size());
+    std::atomic<int> nextCell(0);
+    parallel([&](unsigned int) {
+        for (int i = nextCell++; i < (int) cells.size(); i = nextCell++) {
+            if (cells[i].left < 0) tours[i] = solveCell(cells[i]);
+        }
+    });
+
+    // the halves come after their cell, so going backwards joins them before the cell itself is joined to its sibling
+    std::vector<int> seams;
+    for (int i = cells.size() - 1; i >= 0; i--) {
+        if (cells[i].left < 0) continue;
+        tours[i] = stitch(tours[cells[i].left], tours[cells[i].right], cells[i], seams);
+        std::vector<int>().swap(tours[cells[i].left]);
+        std::vector<int>().swap(tours[cells[i].right]);
+    }
+    tour = Tour(tours[0]);
+    if (n < 8 || seams.empty()) {
+        return view.tourLength(tour);
+    }
+
+    // the seams are repaired with candidates from the coordinates, since a graph this large may have few edges
+    std::vector<std::pair<double, double>> points(n);
+    for (int v = 0; v < n; v++) {
+        points[v] = {coordinates[0][v], coordinates[1][v]};
+    }
+    KdTree kdTree(points);
+    std::vector<std::vector<int>> neighbors(n);
+    parallel([&](unsigned int id) {
+        for (int v = id; v < n; v += threads) {
+            for (int w : kdTree.nearest(points[v].first, points[v].second, PARTITION_NEIGHBORS + 1)) {
+                if (w != v) neighbors[v].push_back(w);
+            }
+        }
+    });
+
+    LocalSearch localSearch(view, std::move(neighbors));
+    localSearch.improve(tour, seams);
+    return view.tourLength(tour);
+}
@@ -0,0 +1,121 @@
+#ifndef ROUTING_ALGORITHM_KARP_PARTITION_H
+#define ROUTING_ALGORITHM_KARP_PARTITION_H
+
+/**
+* @file KarpPartition.h
+* @brief Contains the declaration of the KarpPartition class.
+* @author Luiz, Pedro e Raphael
+* @date 02/06/2023
+*/
+
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <cmath>
+
+#include "data_structures/Graph.h"
+#include "data_structures/DistanceView.h"
+#include "data_structures/Tour.h"
+#include "data_structures/KdTree.h"
+#include "LocalSearch.h"
+#include "LinKernighan.h"
+
+#define PARTITION_CELL_SIZE 500
+#define PARTITION_SEAM_CITIES 25
+#define PARTITION_NEIGHBORS 8
+
+/**
+ * @class KarpPartition
+ * @brief Builds tours of very large graphs with coordinates by Karp's partitioning: the plane is split recursively at
+ * the median of the longer side, the cells are solved independently and their tours are stitched back together.
+ *
+ * The split is a k-d tree over the coordinates of the vertices, which stops at cells of at most a given number of
+ * vertices. Every cell is solved on its own thread with a nearest neighbour tour improved by Lin-Kernighan over a
+ * DistanceView of the cell, so no thread ever needs more than a cell-sized distance matrix. The two tours of the halves
+ * of every split are then joined, from the leaves up, by the exchange of one edge of each that costs the least, among
+ * the edges of the PARTITION_SEAM_CITIES cities of each half closest to the split line. Finally 2-opt + Or-opt repairs the
+ * tour around the seams, with candidate lists of the PARTITION_NEIGHBORS nearest vertices by coordinates.
+ *
+ * Solving the cells takes O(n * c) distance lookups for cells of c vertices, and the stitching O(n log n), so the time
+ * grows almost linearly with n and the cells are spread over the threads.
+ */
+class KarpPartition {
+public:
+    /**
+    * @brief Constructs a KarpPartition object and splits the vertices of the graph into cells.
+    * @param graph The graph, whose vertices should have coordinates.
+    * @param cellSize The maximum number of vertices of a cell.
+    * @param threads The number of threads, or 0 to use one per hardware thread.
+    * @complexity O(n log n)
+    */
+    KarpPartition(Graph *graph, int cellSize = PARTITION_CELL_SIZE, unsigned int threads = 0);
+
+    /**
+    * @brief Solves the cells, stitches their tours and repairs the seams.
+    * @param tour[out] The tour of the whole graph.
+    * @return The length of the tour.
+    * @complexity O(n * c) distance lookups to solve the cells of c vertices, spread over the threads, plus O(n log n).
+    */
+    double solve(Tour &tour);
+
+    /**
+    * @brief Returns the number of cells of the partition.
+    */
+    int getNumCells() const;
+
+private:
+    /**
+    * @brief A node of the k-d tree, which covers the vertices cities[lo] to cities[hi - 1].
+    */
+    struct Cell {
+        int lo, hi;
+        int axis = 0;               // 0 to split by x, 1 by y
+        double line = 0;            // the coordinate of the split
+        int left = -1, right = -1;  // the halves, or -1 for a cell that is solved directly
+    };
+
+    Graph *graph;
+    DistanceView view;
+    int cellSize;
+    unsigned int threads;
+
+    std::vector<double> coordinates[2];     // x (longitude scaled by the cosine of the mean latitude) and y (latitude)
+    std::vector<int> cities;
+    std::vector<Cell> cells;                // every cell comes before its halves
+    int leaves = 0;
+
+    /**
+    * @brief Splits the vertices cities[lo] to cities[hi - 1] at the median of the longer side of their bounding box.
+    * @return The index of the new cell.
+    */
+    int split(int lo, int hi);
+
+    /**
+    * @brief Finds a tour of the vertices of a cell that is not split.
+    * @return The IDs of the vertices in tour order.
+    */
+    std::vector<int> solveCell(const Cell &cell) const;
+
+    /**
+    * @brief Joins the tours of the two halves of a cell into one, replacing one edge of each by two edges across the split.
+    * @param a The tour of the first half.
+    * @param b The tour of the second half.
+    * @param cell The cell that was split.
+    * @param seams[out] The endpoints of the removed edges are added to it.
+    * @return The joined tour.
+    */
+    std::vector<int> stitch(const std::vector<int> &a, const std::vector<int> &b, const Cell &cell, std::vector<int> &seams) const;
+
+    /**
+    * @brief Returns the positions in the tour of the vertices closest to the split line of the cell.
+    */
+    std::vector<int> closestToLine(const std::vector<int> &order, const Cell &cell) const;
+
+    /**
+    * @brief Runs f(id) on the given number of threads, the calling thread being the first.
+    */
+    void parallel(const std::function<void(unsigned int)> &f) const;
+};
+
+#endif
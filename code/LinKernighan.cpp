@@ -0,0 +1,154 @@
+#include "LinKernighan.h"
+
+#define EPSILON 1e-7
+
+static const int breadth[LK_MAX_DEPTH] = {8, 5, 3, 2};
+
+LinKernighan::LinKernighan(const DistanceView &view, int k):
+    LinKernighan(view, view.nearestNeighbors(std::max(k, LS_NEIGHBORS)), k) {}
+
+LinKernighan::LinKernighan(const DistanceView &view, std::vector<std::vector<int>> neighbors):
+    view(view), neighbors(std::move(neighbors)), localSearch(view) {}
+
+LinKernighan::LinKernighan(const DistanceView &view, const std::vector<std::vector<int>> &closest, int k):
+    view(view), neighbors(closest), localSearch(view, closest) {
+    for (auto &list : neighbors) {
+        if ((int) list.size() > k) list.resize(k);
+    }
+}
+
+int LinKernighan::next(int c) const {
+    return tour->next(c);
+}
+
+int LinKernighan::prev(int c) const {
+    return tour->prev(c);
+}
+
+void LinKernighan::exchange(int a1, int a2, int c1, int c2) {
+    if (next(a1) == a2) {
+        tour->flip(a2, c1);
+    } else {
+        tour->flip(a1, c2);
+    }
+}
+
+bool LinKernighan::wasAdded(int a, int b) const {
+    for (auto &f : flips) {
+        if ((f.t2 == a && f.t3 == b) || (f.t2 == b && f.t3 == a)) return true;
+    }
+    return false;
+}
+
+void LinKernighan::activate(int c) {
+    if (dontLook[c]) {
+        dontLook[c] = false;
+        active.push_back(c);
+    }
+}
+
+bool LinKernighan::step(int level, double gain, int t1, int t2) {
+    bool forward = next(t1) == t2;
+
+    // candidates t3 for the new edge {t2, t3}, best first
+    std::vector<std::pair<double, int>> candidates;
+    for (int t3 : neighbors[t2]) {
+        double g1 = gain - view.distance(t2, t3);
+        if (g1 <= EPSILON) break;
+        int t4 = forward ? prev(t3) : next(t3);
+        if (t3 == t1 || t4 == t2 || wasAdded(t3, t4)) continue;
+        candidates.push_back({view.distance(t3, t4) - view.distance(t2, t3), t3});
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const std::pair<double, int> &a, const std::pair<double, int> &b) {
+        return a.first > b.first;
+    });
+
+    int tries = std::min<int>(breadth[level], candidates.size());
+    for (int i = 0; i < tries; i++) {
+        // undoing a flip may reverse the orientation of the tour
+        forward = next(t1) == t2;
+        int t3 = candidates[i].second;
+        int t4 = forward ? prev(t3) : next(t3);
+        double g1 = gain - view.distance(t2, t3) + view.distance(t3, t4);
+
+        exchange(t2, t1, t3, t4);
+        flips.push_back({t1, t2, t3, t4});
+
+        double closed = g1 - view.distance(t4, t1);
+        if (closed > bestGain) {
+            bestGain = closed;
+            bestDepth = flips.size();
+        }
+
+        if (level + 1 < LK_MAX_DEPTH) {
+            step(level + 1, g1, t1, t4);
+        }
+        if (bestGain > EPSILON) {
+            return true;
+        }
+
+        exchange(t2, t3, t1, t4);
+        flips.pop_back();
+    }
+
+    return false;
+}
+
+bool LinKernighan::improve(int t1, int t2) {
+    flips.clear();
+    bestGain = 0;
+    bestDepth = 0;
+
+    if (!step(0, view.distance(t1, t2), t1, t2)) {
+        return false;
+    }
+
+    while (flips.size() > bestDepth) {
+        Flip f = flips.back();
+        exchange(f.t2, f.t3, f.t1, f.t4);
+        flips.pop_back();
+    }
+
+    for (auto &f : flips) {
+        activate(f.t1); activate(f.t2); activate(f.t3); activate(f.t4);
+    }
+
+    return true;
+}
+
+double LinKernighan::optimize(Tour &tour, const std::atomic<bool> *stop) {
+    // starting from the 2-opt + Or-opt local optimum, so the chains can only make it shorter
+    double length = localSearch.optimize(tour, stop);
+    if (tour.size() < 8 || (stop != nullptr && *stop)) {
+        return length;
+    }
+
+    this->tour = &tour;
+    while (true) {
+        dontLook.assign(view.size(), true);
+        active.clear();
+        for (int c : tour.toVector(0)) {
+            activate(c);
+        }
+
+        while (!active.empty()) {
+            int t1 = active.front();
+            active.pop_front();
+            dontLook[t1] = true;
+            if (stop != nullptr && *stop) {
+                return view.tourLength(tour);
+            }
+
+            if (improve(t1, next(t1)) || improve(t1, prev(t1))) {
+                activate(t1);
+            }
+        }
+
+        // the Or-opt moves the chains cannot make, and another round of chains if any of them was applied
+        double chained = view.tourLength(tour);
+        length = localSearch.optimize(tour, stop);
+        if (length >= chained - EPSILON || (stop != nullptr && *stop)) {
+            return length;
+        }
+    }
+}
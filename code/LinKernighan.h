@@ -0,0 +1,117 @@
+#ifndef ROUTING_ALGORITHM_LIN_KERNIGHAN_H
+#define ROUTING_ALGORITHM_LIN_KERNIGHAN_H
+
+/**
+* @file LinKernighan.h
+* @brief Contains the declaration of the LinKernighan class.
+* @author Luiz, Pedro e Raphael
+* @date 02/06/2023
+*/
+
+#include <vector>
+#include <deque>
+#include <algorithm>
+
+#include "data_structures/DistanceView.h"
+#include "data_structures/Tour.h"
+#include "LocalSearch.h"
+
+#define LK_MAX_DEPTH 4
+
+/**
+ * @class LinKernighan
+ * @brief Improves a TSP tour with Lin-Kernighan style variable-depth moves.
+ *
+ * Each move is a chain of up to LK_MAX_DEPTH sequential flips of the Tour that keep the first city fixed,
+ * so the resulting move is at most a 5-opt. The chain is extended while the partial gain stays positive
+ * and the best closed tour along the chain is kept. New edges are taken from the candidate lists.
+ *
+ * The chain has no segment insertion, so the tour is first improved by LocalSearch (2-opt + Or-opt over the
+ * LS_NEIGHBORS nearest neighbours, like Routing::tspLocalSearch) and the two searches then alternate until
+ * LocalSearch finds nothing more. Both only apply improving moves, so the result is never longer than the
+ * 2-opt + Or-opt local optimum reached from the same tour.
+ */
+class LinKernighan {
+public:
+    /**
+    * @brief Constructs a LinKernighan object and computes the candidate lists.
+    * @param view The distances between the cities.
+    * @param k The number of nearest neighbours considered for each city.
+    * @complexity O(n^2) on dense views, see DistanceView::nearestNeighbors.
+    */
+    LinKernighan(const DistanceView &view, int k = 8);
+
+    /**
+    * @brief Constructs a LinKernighan object with precomputed candidate lists, such as the alpha-nearness ones of HeldKarp.
+    * @param view The distances between the cities.
+    * @param neighbors For every city, its candidates sorted by preference.
+    * @complexity O(n k)
+    */
+    LinKernighan(const DistanceView &view, std::vector<std::vector<int>> neighbors);
+
+    /**
+    * @brief Improves a tour until no improving move is found from any city, by the chains or by 2-opt + Or-opt.
+    *
+    * @param tour The tour, which is improved in place.
+    * @param stop An optional flag that stops both searches once it is set by another thread, leaving the moves applied so far.
+    * @return The length of the improved tour.
+    * @complexity At most 8 * 5 * 3 * 2 chains evaluated per city and pass, where each flip costs O(n).
+    */
+    double optimize(Tour &tour, const std::atomic<bool> *stop = nullptr);
+
+private:
+    /**
+    * @brief A 2-opt flip of the chain: the edges {t1, t2} and {t3, t4} were replaced by {t2, t3} and {t1, t4}.
+    */
+    struct Flip {
+        int t1, t2, t3, t4;
+    };
+
+    const DistanceView &view;
+    std::vector<std::vector<int>> neighbors;
+    LocalSearch localSearch;
+
+    Tour *tour = nullptr;
+    std::vector<bool> dontLook;
+    std::deque<int> active;
+
+    std::vector<Flip> flips;
+    double bestGain;
+    unsigned int bestDepth;
+
+    /**
+    * @brief Shares the nearest neighbour lists with the LocalSearch, keeping only the k first ones for the chains.
+    */
+    LinKernighan(const DistanceView &view, const std::vector<std::vector<int>> &closest, int k);
+
+    int next(int c) const;
+    int prev(int c) const;
+
+    /**
+    * @brief Replaces the tour edges {a1, a2} and {c1, c2} by {a1, c1} and {a2, c2}.
+    */
+    void exchange(int a1, int a2, int c1, int c2);
+
+    void activate(int c);
+
+    /**
+    * @brief Checks if the edge {a, b} was added by the current chain, in which case it cannot be removed again.
+    */
+    bool wasAdded(int a, int b) const;
+
+    /**
+    * @brief Extends the chain of flips from the tour edge {t1, t2}.
+    * @param level The number of flips already in the chain.
+    * @param gain The sum of the removed minus the added edges, not counting the closing edge {t1, t2}.
+    * @return True if a chain with positive gain was found.
+    */
+    bool step(int level, double gain, int t1, int t2);
+
+    /**
+    * @brief Tries to improve the tour with a chain starting by removing the edge {t1, t2}.
+    * @return True if the tour was improved.
+    */
+    bool improve(int t1, int t2);
+};
+
+#endif
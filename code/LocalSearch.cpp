@@ -0,0 +1,189 @@
+#include "LocalSearch.h"
+
+#define EPSILON 1e-7
+
+LocalSearch::LocalSearch(const DistanceView &view, int k): view(view), neighbors(view.nearestNeighbors(k)) {}
+
+LocalSearch::LocalSearch(const DistanceView &view, std::vector<std::vector<int>> neighbors):
+    view(view), neighbors(std::move(neighbors)) {}
+
+int LocalSearch::next(int c) const {
+    return tour->next(c);
+}
+
+int LocalSearch::prev(int c) const {
+    return tour->prev(c);
+}
+
+void LocalSearch::twoOptMove(int a, int c) {
+    journal.push_back({a, next(a), c, next(c)});
+    tour->flip(next(a), c);
+}
+
+void LocalSearch::exchange(int a1, int a2, int c1, int c2) {
+    if (next(a1) == a2) {
+        twoOptMove(a1, c1);
+    } else {
+        twoOptMove(a2, c2);
+    }
+}
+
+void LocalSearch::activate(int c) {
+    if (dontLook[c]) {
+        dontLook[c] = false;
+        active.push_back(c);
+    }
+}
+
+bool LocalSearch::improveTwoOpt(int a) {
+    int an = next(a);
+    double d1 = view.distance(a, an);
+    for (int c : neighbors[a]) {
+        double g = d1 - view.distance(a, c);
+        if (g <= EPSILON) break;
+        int cn = next(c);
+        if (c == an || cn == a) continue;
+        if (g + view.distance(c, cn) - view.distance(an, cn) > EPSILON) {
+            gain += g + view.distance(c, cn) - view.distance(an, cn);
+            twoOptMove(a, c);
+            activate(a); activate(an); activate(c); activate(cn);
+            return true;
+        }
+    }
+
+    int ap = prev(a);
+    d1 = view.distance(ap, a);
+    for (int c : neighbors[a]) {
+        double g = d1 - view.distance(a, c);
+        if (g <= EPSILON) break;
+        int cp = prev(c);
+        if (c == ap || cp == a) continue;
+        if (g + view.distance(cp, c) - view.distance(ap, cp) > EPSILON) {
+            gain += g + view.distance(cp, c) - view.distance(ap, cp);
+            twoOptMove(ap, cp);
+            activate(a); activate(ap); activate(c); activate(cp);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool LocalSearch::moveSegment(int s1, int s2, int length) {
+    int p = prev(s1), nx = next(s2);
+    if (p == nx) return false;
+
+    double removeGain = view.distance(p, s1) + view.distance(s2, nx) - view.distance(p, nx);
+    if (removeGain <= EPSILON) return false;
+
+    auto inSegment = [&](int c) {
+        int v = s1;
+        for (int i = 0; i < length; i++, v = next(v)) {
+            if (v == c) return true;
+        }
+        return false;
+    };
+
+    for (int s : {s1, s2}) {
+        for (int c : neighbors[s]) {
+            if (view.distance(s, c) >= removeGain) break;
+            if (inSegment(c)) continue;
+
+            for (int side = 0; side < 2; side++) {
+                int x = side == 0 ? c : prev(c);
+                int y = side == 0 ? next(c) : c;
+                if (inSegment(x) || inSegment(y) || x == nx || y == p) continue;
+
+                double base = view.distance(x, y);
+                double forward = view.distance(x, s1) + view.distance(s2, y) - base;
+                double reversed = view.distance(x, s2) + view.distance(s1, y) - base;
+                if (removeGain - std::min(forward, reversed) <= EPSILON) continue;
+                gain += removeGain - std::min(forward, reversed);
+
+                exchange(p, s1, x, y);
+                exchange(x, p, s2, nx);
+                if (forward < reversed) {
+                    exchange(x, s2, s1, y);
+                }
+
+                activate(p); activate(nx); activate(s1); activate(s2); activate(x); activate(y);
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+bool LocalSearch::improveOrOpt(int a) {
+    int last = a, first = a;
+    for (int length = 1; length <= 3; length++) {
+        if (moveSegment(a, last, length) || (length > 1 && moveSegment(first, a, length))) {
+            return true;
+        }
+        last = next(last);
+        first = prev(first);
+    }
+    return false;
+}
+
+void LocalSearch::run(const std::atomic<bool> *stop) {
+    while (!active.empty()) {
+        int a = active.front();
+        active.pop_front();
+        dontLook[a] = true;
+        if (stop != nullptr && *stop) {
+            continue;
+        }
+
+        if (improveTwoOpt(a) || improveOrOpt(a)) {
+            activate(a);
+        }
+    }
+}
+
+double LocalSearch::optimize(Tour &tour, const std::atomic<bool> *stop) {
+    if (tour.size() < 8) {
+        return view.tourLength(tour);
+    }
+
+    this->tour = &tour;
+    dontLook.assign(view.size(), true);
+    active.clear();
+    journal.clear();
+    for (int c : tour.toVector(0)) {
+        activate(c);
+    }
+
+    run(stop);
+    return view.tourLength(tour);
+}
+
+double LocalSearch::improve(Tour &tour, const std::vector<int> &cities) {
+    this->tour = &tour;
+    journal.clear();
+    gain = 0;
+    if (tour.size() < 8) {
+        return 0;
+    }
+
+    // the queue is empty after every search, so every don't-look bit is set again
+    if ((int) dontLook.size() != view.size()) {
+        dontLook.assign(view.size(), true);
+    }
+    for (int c : cities) {
+        activate(c);
+    }
+
+    run();
+    return gain;
+}
+
+void LocalSearch::undo() {
+    std::vector<Move> moves;
+    moves.swap(journal);
+    for (auto it = moves.rbegin(); it != moves.rend(); it++) {
+        exchange(it->a1, it->c1, it->a2, it->c2);
+    }
+    journal.clear();
+}
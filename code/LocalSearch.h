@@ -0,0 +1,142 @@
+#ifndef ROUTING_ALGORITHM_LOCAL_SEARCH_H
+#define ROUTING_ALGORITHM_LOCAL_SEARCH_H
+
+/**
+* @file LocalSearch.h
+* @brief Contains the declaration of the LocalSearch class.
+* @author Luiz, Pedro e Raphael
+* @date 02/06/2023
+*/
+
+#include <vector>
+#include <deque>
+#include <atomic>
+
+#include "data_structures/DistanceView.h"
+#include "data_structures/Tour.h"
+
+#define LS_NEIGHBORS 10
+
+/**
+ * @class LocalSearch
+ * @brief Improves a TSP tour with 2-opt and Or-opt moves.
+ *
+ * The moves are restricted to the k nearest neighbours of each city and driven by don't-look bits,
+ * so a pass over the tour takes near-linear time.
+ */
+class LocalSearch {
+public:
+    /**
+    * @brief Constructs a LocalSearch object and computes the candidate lists.
+    * @param view The distances between the cities.
+    * @param k The number of nearest neighbours considered for each city.
+    * @complexity O(n^2) on dense views, see DistanceView::nearestNeighbors.
+    */
+    LocalSearch(const DistanceView &view, int k = LS_NEIGHBORS);
+
+    /**
+    * @brief Constructs a LocalSearch object with precomputed candidate lists, so several searches can share them.
+    * @param view The distances between the cities.
+    * @param neighbors For every city, its candidates sorted by increasing distance.
+    * @complexity O(n k)
+    */
+    LocalSearch(const DistanceView &view, std::vector<std::vector<int>> neighbors);
+
+    /**
+    * @brief Improves a tour until no improving 2-opt or Or-opt move is left.
+    *
+    * @param tour The tour, which is improved in place.
+    * @param stop An optional flag that stops the search once it is set by another thread, leaving the moves applied so far.
+    * @return The length of the improved tour.
+    * @complexity Near-linear per pass, O(n k) moves evaluated, where n is the number of cities.
+    */
+    double optimize(Tour &tour, const std::atomic<bool> *stop = nullptr);
+
+    /**
+    * @brief Improves a tour starting only from the given cities, as after a small perturbation of a locally optimal tour.
+    *
+    * The applied moves are recorded, so they can be reverted with undo().
+    *
+    * @param tour The tour, which is improved in place.
+    * @param cities The cities whose don't-look bits are cleared.
+    * @return The total gain of the applied moves.
+    * @complexity Proportional to the number of cities reached by the search, not to the size of the tour.
+    */
+    double improve(Tour &tour, const std::vector<int> &cities);
+
+    /**
+    * @brief Reverts the moves applied by the last call to improve().
+    * @complexity O(m) flips, where m is the number of applied moves.
+    */
+    void undo();
+
+private:
+    /**
+    * @brief A 2-opt move that replaced the tour edges {a1, a2} and {c1, c2} by {a1, c1} and {a2, c2}.
+    */
+    struct Move {
+        int a1, a2, c1, c2;
+    };
+
+    const DistanceView &view;
+    std::vector<std::vector<int>> neighbors;
+
+    Tour *tour = nullptr;
+    std::vector<bool> dontLook;
+    std::deque<int> active;
+    std::vector<Move> journal;
+    double gain = 0;
+
+    /**
+    * @brief Returns the city after c in the tour.
+    */
+    int next(int c) const;
+
+    /**
+    * @brief Returns the city before c in the tour.
+    */
+    int prev(int c) const;
+
+    /**
+    * @brief Replaces the edges (a, next(a)) and (c, next(c)) by (a, c) and (next(a), next(c)).
+    */
+    void twoOptMove(int a, int c);
+
+    /**
+    * @brief Applies a 2-opt move that replaces the tour edges {a1, a2} and {c1, c2} by {a1, c1} and {a2, c2}.
+    *
+    * The orientation of both edges is read from the current tour, so it can be used after other moves.
+    */
+    void exchange(int a1, int a2, int c1, int c2);
+
+    /**
+    * @brief Clears the don't-look bit of a city and queues it.
+    */
+    void activate(int c);
+
+    /**
+    * @brief Tries every improving 2-opt move with one endpoint in city a and applies the first one found.
+    * @return True if the tour was improved.
+    */
+    bool improveTwoOpt(int a);
+
+    /**
+    * @brief Tries to move a segment of 1 to 3 cities starting or ending in city a next to one of its neighbours.
+    * @return True if the tour was improved.
+    */
+    bool improveOrOpt(int a);
+
+    /**
+    * @brief Tries to move the segment s1..s2 (following next) between a neighbour of s1 and its successor or predecessor.
+    * @return True if the tour was improved.
+    */
+    bool moveSegment(int s1, int s2, int length);
+
+    /**
+    * @brief Applies moves from the queued cities until the queue is empty.
+    * @param stop An optional flag that empties the queue without trying the cities left once it is set.
+    */
+    void run(const std::atomic<bool> *stop = nullptr);
+};
+
+#endif
@@ -9,10 +9,16 @@ void Menu::menu() {
     std::cout << " \t\t\t\t\t\t\t\t\t\t\t\tMENU\n";
     std::cout << "=================================================================================================\n\n";
 
-    std::cout << "Selecione uma das seguintes opções (0-3):\n";
+    std::cout << "Selecione uma das seguintes opções (0-9):\n";
     std::cout << "1- Backtracking Algorithm\n";
     std::cout << "2- Triangular Approximation Heuristic\n";
     std::cout << "3- Other Heuristics\n";
+    std::cout << "4- Local Search (2-opt + Or-opt / Lin-Kernighan)\n";
+    std::cout << "5- Results Table\n";
+    std::cout << "6- Metaheuristics\n";
+    std::cout << "7- Shortest Paths (Floyd-Warshall / Dijkstra / A*)\n";
+    std::cout << "8- Subset TSP\n";
+    std::cout << "9- Edge Weight Updates (Dynamic MST)\n";
     std::cout << "0- Sair\n";
 }
 
@@ -35,6 +41,24 @@ void Menu::principal() {
             case 3:
                 otherHeuristicsMenu();
                 break;
+            case 4:
+                localSearchMenu();
+                break;
+            case 5:
+                resultsTableMenu();
+                break;
+            case 6:
+                metaheuristicsMenu();
+                break;
+            case 7:
+                shortestPathsMenu();
+                break;
+            case 8:
+                subsetMenu();
+                break;
+            case 9:
+                edgeUpdatesMenu();
+                break;
 
             default:
                 std::cout << "Opção inválida. Favor selecionar uma opção válida\n";
@@ -50,6 +74,8 @@ void Menu::backtrackingMenu() {
     auto duration = std::chrono::duration_cast<std::chrono::duration<double>>(end - start).count();
 
     cout << "The distance is: " << dist << '\n';
+
+    printGap(dist);
     cout << "The execution time is: " << duration << " seconds" << '\n';
     cout << "The path is: " << '\n';
 
@@ -64,32 +90,42 @@ void Menu::backtrackingMenu() {
 }
 
 void Menu::triangularHeuristicMenu() {
-    std::vector<int> path;
+    Tour tour;
     double dist;
 
     auto start = std::chrono::high_resolution_clock::now();
-    dist = routingOperations.tspTriangApproximation(graph, path);
+    dist = routingOperations.tspTriangApproximation(graph, tour);
     auto end = std::chrono::high_resolution_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::duration<double>>(end - start).count();
 
     cout << "The distance is: " << dist << '\n';
+
+    printGap(dist);
     cout << "The execution time is: " << duration << " seconds" << '\n';
     cout << "The path is: ";
 
-    for (auto i : path) {
+    for (auto i : tour.getPath(0)) {
         cout << i << " ";
     }
     cout << std::endl;
 }
 
 void Menu::otherHeuristicsMenu() {
-    std::vector<int> path;
+    Tour tour;
     double dist;
 
     do {
-        std::cout << "Selecione uma das seguintes opções (0-2):\n";
+        std::cout << "Selecione uma das seguintes opções (0-10):\n";
         std::cout << "1- Heuristic Approximation\n";
         std::cout << "2- Christofides Approximation\n";
+        std::cout << "3- Greedy Edge\n";
+        std::cout << "4- Hilbert Curve (grafos com coordenadas)\n";
+        std::cout << "5- Cheapest Insertion\n";
+        std::cout << "6- Farthest Insertion\n";
+        std::cout << "7- Nearest Insertion\n";
+        std::cout << "8- Clarke-Wright Savings\n";
+        std::cout << "9- Multi-start (Triangular / Heuristic Approximation)\n";
+        std::cout << "10- Karp Partition (grafos grandes com coordenadas)\n";
         std::cout << "0- Sair\n";
         std::cin >> option;
         std::cin.ignore();
@@ -100,16 +136,19 @@ void Menu::otherHeuristicsMenu() {
                 break;
             case 1:
             {   auto start = std::chrono::high_resolution_clock::now();
-                dist = routingOperations.TspHeuristicApprox(graph, path);
+                dist = routingOperations.TspHeuristicApprox(graph, tour);
                 auto end = std::chrono::high_resolution_clock::now();
                 auto duration = std::chrono::duration_cast<std::chrono::duration<double>>(end - start).count();
 
 
                 cout << "The distance is: " << dist << '\n';
+
+
+                printGap(dist);
                 cout << "The execution time is: " << duration << " seconds" << '\n';
                 cout << "The path is: ";
 
-                for (auto i : path) {
+                for (auto i : tour.getPath(0)) {
                     cout << i << " ";
                 }
                 cout << std::endl;
@@ -118,16 +157,217 @@ void Menu::otherHeuristicsMenu() {
             }
                 break;
             case 2:
+            {    int matching;
+                do {
+                    std::cout << "Selecione o emparelhamento (1- Exato (blossom), 2- Guloso + 2-opt):\n";
+                    std::cin >> matching;
+                    std::cin.ignore();
+                } while (matching != 1 && matching != 2);
+
+                double matchingCost, matchingTime;
+                auto start = std::chrono::high_resolution_clock::now();
+                dist = routingOperations.TspChristofidesApprox(graph, tour, matching == 1 ? exactMatching : greedyMatching, matchingCost, matchingTime);
+                auto end = std::chrono::high_resolution_clock::now();
+                auto duration = std::chrono::duration_cast<std::chrono::duration<double>>(end - start).count();
+
+                cout << "The distance is: " << dist << '\n';
+
+                printGap(dist);
+                cout << "The execution time is: " << duration << " seconds" << '\n';
+                cout << "The matching cost is: " << matchingCost << '\n';
+                cout << "The matching time is: " << matchingTime << " seconds" << '\n';
+                cout << "The path is: ";
+
+                for (auto i : tour.getPath(0)) {
+                    cout << i << " ";
+                }
+                cout << std::endl;
+
+                quit = true;
+            }
+                break;
+            case 3:
+            {    auto start = std::chrono::high_resolution_clock::now();
+                dist = routingOperations.tspGreedyEdge(graph, tour);
+                auto end = std::chrono::high_resolution_clock::now();
+                auto duration = std::chrono::duration_cast<std::chrono::duration<double>>(end - start).count();
+
+                cout << "The distance is: " << dist << '\n';
+
+                printGap(dist);
+                cout << "The execution time is: " << duration << " seconds" << '\n';
+                cout << "The path is: ";
+
+                for (auto i : tour.getPath(0)) {
+                    cout << i << " ";
+                }
+                cout << std::endl;
+
+                quit = true;
+            }
+                break;
+            case 4:
+            {    auto start = std::chrono::high_resolution_clock::now();
+                dist = routingOperations.tspHilbertCurve(graph, tour);
+                auto end = std::chrono::high_resolution_clock::now();
+                auto duration = std::chrono::duration_cast<std::chrono::duration<double>>(end - start).count();
+
+                cout << "The distance is: " << dist << '\n';
+
+                printGap(dist);
+                cout << "The execution time is: " << duration << " seconds" << '\n';
+                cout << "The path is: ";
+
+                for (auto i : tour.getPath(0)) {
+                    cout << i << " ";
+                }
+                cout << std::endl;
+
+                quit = true;
+            }
+                break;
+            case 5:
+            {    auto start = std::chrono::high_resolution_clock::now();
+                dist = routingOperations.tspCheapestInsertion(graph, tour);
+                auto end = std::chrono::high_resolution_clock::now();
+                auto duration = std::chrono::duration_cast<std::chrono::duration<double>>(end - start).count();
+
+                cout << "The distance is: " << dist << '\n';
+
+                printGap(dist);
+                cout << "The execution time is: " << duration << " seconds" << '\n';
+                cout << "The path is: ";
+
+                for (auto i : tour.getPath(0)) {
+                    cout << i << " ";
+                }
+                cout << std::endl;
+
+                quit = true;
+            }
+                break;
+            case 6:
+            {    auto start = std::chrono::high_resolution_clock::now();
+                dist = routingOperations.tspFarthestInsertion(graph, tour);
+                auto end = std::chrono::high_resolution_clock::now();
+                auto duration = std::chrono::duration_cast<std::chrono::duration<double>>(end - start).count();
+
+                cout << "The distance is: " << dist << '\n';
+
+                printGap(dist);
+                cout << "The execution time is: " << duration << " seconds" << '\n';
+                cout << "The path is: ";
+
+                for (auto i : tour.getPath(0)) {
+                    cout << i << " ";
+                }
+                cout << std::endl;
+
+                quit = true;
+            }
+                break;
+            case 7:
             {    auto start = std::chrono::high_resolution_clock::now();
-                dist = routingOperations.TspChristofidesApprox(graph, path);
+                dist = routingOperations.tspNearestInsertion(graph, tour);
                 auto end = std::chrono::high_resolution_clock::now();
                 auto duration = std::chrono::duration_cast<std::chrono::duration<double>>(end - start).count();
 
                 cout << "The distance is: " << dist << '\n';
+
+                printGap(dist);
                 cout << "The execution time is: " << duration << " seconds" << '\n';
                 cout << "The path is: ";
 
-                for (auto i : path) {
+                for (auto i : tour.getPath(0)) {
+                    cout << i << " ";
+                }
+                cout << std::endl;
+
+                quit = true;
+            }
+                break;
+            case 8:
+            {    auto start = std::chrono::high_resolution_clock::now();
+                dist = routingOperations.tspSavings(graph, tour);
+                auto end = std::chrono::high_resolution_clock::now();
+                auto duration = std::chrono::duration_cast<std::chrono::duration<double>>(end - start).count();
+
+                cout << "The distance is: " << dist << '\n';
+
+                printGap(dist);
+                cout << "The execution time is: " << duration << " seconds" << '\n';
+                cout << "The path is: ";
+
+                for (auto i : tour.getPath(0)) {
+                    cout << i << " ";
+                }
+                cout << std::endl;
+
+                quit = true;
+            }
+                break;
+            case 9:
+            {   int construction, starts, depot;
+                unsigned int threads;
+                do {
+                    std::cout << "Selecione a construção (1- Triangular Approximation, 2- Heuristic Approximation):\n";
+                    std::cin >> construction;
+                    std::cin.ignore();
+                } while (construction < 1 || construction > 2);
+                std::cout << "Insira o número de vértices de partida (0 para usar todos):\n";
+                std::cin >> starts;
+                std::cout << "Insira o vértice onde o percurso começa:\n";
+                std::cin >> depot;
+                std::cout << "Insira o número de threads (0 para usar todos os núcleos):\n";
+                std::cin >> threads;
+                std::cin.ignore();
+
+                auto start = std::chrono::high_resolution_clock::now();
+                dist = routingOperations.tspMultiStart(graph, tour, construction, starts, depot, threads);
+                auto end = std::chrono::high_resolution_clock::now();
+                auto duration = std::chrono::duration_cast<std::chrono::duration<double>>(end - start).count();
+
+                if (tour.empty()) {
+                    cout << "The vertex is not in the graph." << std::endl;
+                    quit = true;
+                    break;
+                }
+
+                cout << "The distance is: " << dist << '\n';
+
+                printGap(dist);
+                cout << "The execution time is: " << duration << " seconds" << '\n';
+                cout << "The path is: ";
+
+                for (auto i : tour.getPath(depot)) {
+                    cout << i << " ";
+                }
+                cout << std::endl;
+
+                quit = true;
+            }
+                break;
+            case 10:
+            {   int cellSize;
+                unsigned int threads;
+                std::cout << "Insira o número máximo de vértices de cada célula:\n";
+                std::cin >> cellSize;
+                std::cout << "Insira o número de threads (0 para usar todos os núcleos):\n";
+                std::cin >> threads;
+                std::cin.ignore();
+
+                auto start = std::chrono::high_resolution_clock::now();
+                dist = routingOperations.tspPartition(graph, tour, cellSize, threads);
+                auto end = std::chrono::high_resolution_clock::now();
+                auto duration = std::chrono::duration_cast<std::chrono::duration<double>>(end - start).count();
+
+                cout << "The distance is: " << dist << '\n';
+
+                printGap(dist);
+                cout << "The execution time is: " << duration << " seconds" << '\n';
+                cout << "The path is: ";
+
+                for (auto i : tour.getPath(0)) {
                     cout << i << " ";
                 }
                 cout << std::endl;
@@ -142,3 +382,529 @@ void Menu::otherHeuristicsMenu() {
     } while (!quit);
     quit = false;
 }
+
+double Menu::runHeuristic(int heuristic, Tour &tour) {
+    switch (heuristic) {
+        case 1:
+            return routingOperations.tspTriangApproximation(graph, tour);
+        case 2:
+            return routingOperations.TspHeuristicApprox(graph, tour);
+        case 3:
+            return routingOperations.TspChristofidesApprox(graph, tour);
+        case 4:
+            return routingOperations.tspGreedyEdge(graph, tour);
+        case 5:
+            return routingOperations.tspHilbertCurve(graph, tour);
+        case 6:
+            return routingOperations.tspCheapestInsertion(graph, tour);
+        case 7:
+            return routingOperations.tspFarthestInsertion(graph, tour);
+        case 8:
+            return routingOperations.tspNearestInsertion(graph, tour);
+        default:
+            return routingOperations.tspSavings(graph, tour);
+    }
+}
+
+double Menu::getLowerBound(double upperBound) {
+    if (lowerBound < 0) {
+        lowerBound = routingOperations.heldKarpBound(graph, upperBound, HK_TIME_LIMIT);
+    }
+    return lowerBound;
+}
+
+void Menu::printGap(double dist) {
+    double bound = getLowerBound(dist);
+    if (bound < 0) {
+        cout << "The lower bound is not available for graphs with more than " << MAX_DENSE_VERTICES << " vertices" << '\n';
+        return;
+    }
+
+    cout << "The lower bound is: " << bound << '\n';
+    if (bound > 0) {
+        cout << "The optimality gap is at most: " << 100.0 * (dist - bound) / bound << "%" << '\n';
+    }
+}
+
+void Menu::localSearchMenu() {
+    Tour tour;
+
+    do {
+        std::cout << "Selecione a heurística que gera o tour inicial (0-9):\n";
+        std::cout << "1- Triangular Approximation\n";
+        std::cout << "2- Heuristic Approximation\n";
+        std::cout << "3- Christofides Approximation\n";
+        std::cout << "4- Greedy Edge\n";
+        std::cout << "5- Hilbert Curve (grafos com coordenadas)\n";
+        std::cout << "6- Cheapest Insertion\n";
+        std::cout << "7- Farthest Insertion\n";
+        std::cout << "8- Nearest Insertion\n";
+        std::cout << "9- Clarke-Wright Savings\n";
+        std::cout << "0- Sair\n";
+        std::cin >> option;
+        std::cin.ignore();
+
+        if (option < 0 || option > 9) {
+            std::cout << "Opção inválida. Favor selecionar uma opção válida\n";
+        }
+    } while (option < 0 || option > 9);
+
+    if (option == 0) {
+        return;
+    }
+    int heuristic = option;
+
+    do {
+        std::cout << "Selecione o algoritmo de melhoria (0-3):\n";
+        std::cout << "1- 2-opt + Or-opt\n";
+        std::cout << "2- Lin-Kernighan\n";
+        std::cout << "3- Lin-Kernighan (candidatos alpha-nearness)\n";
+        std::cout << "0- Sair\n";
+        std::cin >> option;
+        std::cin.ignore();
+
+        if (option < 0 || option > 3) {
+            std::cout << "Opção inválida. Favor selecionar uma opção válida\n";
+        }
+    } while (option < 0 || option > 3);
+
+    if (option == 0) {
+        return;
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    double initialDist = runHeuristic(heuristic, tour);
+    auto middle = std::chrono::high_resolution_clock::now();
+    double dist;
+    if (option == 1) {
+        dist = routingOperations.tspLocalSearch(graph, tour);
+    } else if (option == 2) {
+        dist = routingOperations.tspLinKernighan(graph, tour);
+    } else {
+        dist = routingOperations.tspLinKernighanAlpha(graph, tour, HK_TIME_LIMIT);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+
+    auto constructionDuration = std::chrono::duration_cast<std::chrono::duration<double>>(middle - start).count();
+    auto searchDuration = std::chrono::duration_cast<std::chrono::duration<double>>(end - middle).count();
+
+    cout << "The initial distance is: " << initialDist << '\n';
+    cout << "The construction time is: " << constructionDuration << " seconds" << '\n';
+    cout << "The distance after local search is: " << dist << '\n';
+    printGap(dist);
+    cout << "The local search time is: " << searchDuration << " seconds" << '\n';
+    cout << "The path is: ";
+
+    for (auto i : tour.getPath(0)) {
+        cout << i << " ";
+    }
+    cout << std::endl;
+}
+
+void Menu::resultsTableMenu() {
+    const std::string names[] = {"Triangular Approximation", "Heuristic Approximation", "Christofides Approximation", "Greedy Edge", "Hilbert Curve",
+                                 "Cheapest Insertion", "Farthest Insertion", "Nearest Insertion", "Clarke-Wright Savings"};
+    std::vector<std::string> rows;
+    std::vector<double> dists, durations;
+
+    for (int heuristic = 1; heuristic <= 9; heuristic++) {
+        // the Hilbert curve only uses the coordinates, which the toy and medium-size graphs do not have
+        if (heuristic == 5 && type != realGraph && type != externGraph) {
+            continue;
+        }
+
+        Tour tour;
+
+        auto start = std::chrono::high_resolution_clock::now();
+        double dist = runHeuristic(heuristic, tour);
+        auto middle = std::chrono::high_resolution_clock::now();
+        Tour lkTour = tour;
+        double improved = routingOperations.tspLocalSearch(graph, tour);
+        auto end = std::chrono::high_resolution_clock::now();
+        double lkImproved = routingOperations.tspLinKernighan(graph, lkTour);
+        auto lkEnd = std::chrono::high_resolution_clock::now();
+
+        double construction = std::chrono::duration_cast<std::chrono::duration<double>>(middle - start).count();
+
+        rows.push_back(names[heuristic - 1]);
+        dists.push_back(dist);
+        durations.push_back(construction);
+
+        rows.push_back(names[heuristic - 1] + " + 2-opt/Or-opt");
+        dists.push_back(improved);
+        durations.push_back(std::chrono::duration_cast<std::chrono::duration<double>>(end - start).count());
+
+        rows.push_back(names[heuristic - 1] + " + Lin-Kernighan");
+        dists.push_back(lkImproved);
+        durations.push_back(construction + std::chrono::duration_cast<std::chrono::duration<double>>(lkEnd - end).count());
+    }
+
+    double best = *std::min_element(dists.begin(), dists.end());
+    double bound = getLowerBound(best);
+
+    cout << std::left << std::setw(45) << "Algorithm" << std::setw(16) << "Distance"
+         << std::setw(12) << "Gap (%)" << std::setw(16) << "Bound gap (%)" << "Time (s)" << '\n';
+    for (unsigned int i = 0; i < rows.size(); i++) {
+        double gap = best > 0 ? 100.0 * (dists[i] - best) / best : 0;
+        cout << std::left << std::setw(45) << rows[i] << std::setw(16) << std::fixed << std::setprecision(1) << dists[i]
+             << std::setw(12) << std::setprecision(2) << gap;
+        if (bound > 0) {
+            cout << std::setw(16) << 100.0 * (dists[i] - bound) / bound;
+        } else {
+            cout << std::setw(16) << "-";
+        }
+        cout << std::setprecision(4) << durations[i] << '\n';
+    }
+    cout.unsetf(std::ios::fixed);
+    cout << std::setprecision(6) << std::right;
+    cout << "The gap is measured against the shortest tour in the table, and the bound gap against the Held-Karp lower bound";
+    if (bound > 0) {
+        cout << " (" << bound << ")";
+    }
+    cout << '.' << std::endl;
+}
+
+void Menu::metaheuristicsMenu() {
+    Tour tour;
+
+    do {
+        std::cout << "Selecione uma das seguintes opções (0-4):\n";
+        std::cout << "1- Iterated Local Search (double-bridge, multi-threaded)\n";
+        std::cout << "2- Genetic Algorithm (island model, EAX)\n";
+        std::cout << "3- Ant Colony Optimization (MAX-MIN, candidate lists)\n";
+        std::cout << "4- Portfolio (algoritmos em paralelo até ao limite de tempo)\n";
+        std::cout << "0- Sair\n";
+        std::cin >> option;
+        std::cin.ignore();
+
+        if (option < 0 || option > 4) {
+            std::cout << "Opção inválida. Favor selecionar uma opção válida\n";
+        }
+    } while (option < 0 || option > 4);
+
+    if (option == 0) {
+        return;
+    }
+
+    double timeLimit;
+    unsigned int threads;
+    std::cout << "Insira o limite de tempo (segundos):\n";
+    std::cin >> timeLimit;
+    std::cout << "Insira o número de threads (0 para usar todos os núcleos):\n";
+    std::cin >> threads;
+    std::cin.ignore();
+
+    if (option == 1) {
+        auto start = std::chrono::high_resolution_clock::now();
+        double initialDist = routingOperations.TspChristofidesApprox(graph, tour);
+        auto middle = std::chrono::high_resolution_clock::now();
+        double dist = routingOperations.tspIteratedLocalSearch(graph, tour, timeLimit, threads);
+        auto end = std::chrono::high_resolution_clock::now();
+
+        auto constructionDuration = std::chrono::duration_cast<std::chrono::duration<double>>(middle - start).count();
+        auto searchDuration = std::chrono::duration_cast<std::chrono::duration<double>>(end - middle).count();
+
+        cout << "The Christofides distance is: " << initialDist << '\n';
+        cout << "The construction time is: " << constructionDuration << " seconds" << '\n';
+        cout << "The distance after the metaheuristic is: " << dist << '\n';
+        printGap(dist);
+        cout << "The metaheuristic time is: " << searchDuration << " seconds" << '\n';
+    } else if (option == 2) {
+        auto start = std::chrono::high_resolution_clock::now();
+        double dist = routingOperations.tspGeneticAlgorithm(graph, tour, timeLimit, threads);
+        auto end = std::chrono::high_resolution_clock::now();
+        auto duration = std::chrono::duration_cast<std::chrono::duration<double>>(end - start).count();
+
+        cout << "The distance is: " << dist << '\n';
+
+        printGap(dist);
+        cout << "The execution time is: " << duration << " seconds" << '\n';
+    } else if (option == 4) {
+        bool optimal;
+        std::vector<Portfolio::SolverStats> stats;
+
+        auto start = std::chrono::high_resolution_clock::now();
+        double dist = routingOperations.tspPortfolio(graph, tour, timeLimit, threads, optimal, stats);
+        auto end = std::chrono::high_resolution_clock::now();
+        auto duration = std::chrono::duration_cast<std::chrono::duration<double>>(end - start).count();
+
+        cout << "The distance is: " << dist << (optimal ? " (optimal)" : "") << '\n';
+
+        printGap(dist);
+        cout << "The execution time is: " << duration << " seconds" << '\n';
+        cout << std::left << std::setw(32) << "Solver" << std::setw(16) << "Predicted (s)" << std::setw(16) << "Time (s)" << "Distance" << '\n';
+        for (auto &solver : stats) {
+            cout << std::setw(32) << solver.name << std::setw(16) << (solver.predicted < 0 ? "-" : std::to_string(solver.predicted));
+            if (!solver.launched) {
+                cout << "not launched" << '\n';
+                continue;
+            }
+            cout << std::setw(16) << solver.seconds;
+            if (solver.finished) cout << solver.length << '\n';
+            else cout << "stopped" << '\n';
+        }
+        cout << std::right;
+    } else {
+        std::vector<std::pair<double, double>> history;
+
+        auto start = std::chrono::high_resolution_clock::now();
+        double dist = routingOperations.tspAntColony(graph, tour, timeLimit, threads, history);
+        auto end = std::chrono::high_resolution_clock::now();
+        auto duration = std::chrono::duration_cast<std::chrono::duration<double>>(end - start).count();
+
+        cout << "The distance is: " << dist << '\n';
+
+        printGap(dist);
+        cout << "The execution time is: " << duration << " seconds" << '\n';
+        cout << "The time-to-quality curve is:\n";
+        cout << std::left << std::setw(16) << "Time (s)" << "Distance" << '\n';
+        for (auto &point : history) {
+            cout << std::left << std::setw(16) << point.first << point.second << '\n';
+        }
+        cout << std::right;
+    }
+
+    cout << "The path is: ";
+    for (auto i : tour.getPath(0)) {
+        cout << i << " ";
+    }
+    cout << std::endl;
+}
+
+void Menu::shortestPathsMenu() {
+    int method;
+    do {
+        std::cout << "Selecione o algoritmo (1- Floyd-Warshall, 2- Dijkstra a partir de cada vértice, 3- A* bidirecional sob demanda com cache LRU):\n";
+        std::cin >> method;
+        std::cin.ignore();
+    } while (method < 1 || method > 3);
+
+    if (method == 3) {
+        std::size_t capacity;
+        std::cout << "Insira a capacidade da cache (número de pares):\n";
+        std::cin >> capacity;
+        std::cin.ignore();
+
+        if (!graph->enableDistanceCache(capacity)) {
+            cout << "The vertex IDs must be 0 to " << graph->getNumVertex() - 1 << '\n';
+            return;
+        }
+        lowerBound = -1;
+        cout << "The heuristics now use the shortest path distances between the vertices, computed on demand." << '\n';
+
+        int sourc, dest;
+        std::cout << "Insira os vértices de origem e de destino da distância a mostrar:\n";
+        std::cin >> sourc >> dest;
+        std::cin.ignore();
+
+        auto start = std::chrono::high_resolution_clock::now();
+        double dist = graph->getDistance(sourc, dest);
+        auto end = std::chrono::high_resolution_clock::now();
+        auto duration = std::chrono::duration_cast<std::chrono::duration<double>>(end - start).count();
+
+        cout << "The distance is: " << dist << '\n';
+        cout << "The execution time is: " << duration << " seconds" << std::endl;
+        return;
+    }
+
+    if (graph->getNumVertex() > MAX_DENSE_VERTICES) {
+        cout << "The shortest paths are not available for graphs with more than " << MAX_DENSE_VERTICES << " vertices" << '\n';
+        return;
+    }
+
+    unsigned int threads;
+    std::cout << "Insira o número de threads (0 para usar todos os núcleos):\n";
+    std::cin >> threads;
+    std::cin.ignore();
+
+    auto start = std::chrono::high_resolution_clock::now();
+    bool built = method == 1 ? graph->buildShortestPaths(threads) : graph->buildRoadDistances(threads);
+    auto end = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::duration<double>>(end - start).count();
+
+    if (!built) {
+        cout << "The vertex IDs must be 0 to " << graph->getNumVertex() - 1 << '\n';
+        return;
+    }
+    // the distances changed, so the bound has to be computed again
+    lowerBound = -1;
+
+    cout << "The execution time is: " << duration << " seconds" << '\n';
+    cout << "The heuristics now use the shortest path distances between the vertices." << '\n';
+
+    int sourc, dest;
+    std::cout << "Insira os vértices de origem e de destino do caminho a mostrar:\n";
+    std::cin >> sourc >> dest;
+    std::cin.ignore();
+
+    std::vector<int> path = graph->getShortestPath(sourc, dest);
+    if (path.empty()) {
+        cout << "There is no path between the vertices." << std::endl;
+        return;
+    }
+
+    cout << "The distance is: " << graph->getDistance(sourc, dest) << '\n';
+    cout << "The path is: ";
+    for (auto i : path) {
+        cout << i << " ";
+    }
+    cout << std::endl;
+}
+
+void Menu::subsetMenu() {
+    int count;
+    std::cout << "Insira o número de vértices a visitar:\n";
+    std::cin >> count;
+    std::cin.ignore();
+
+    std::vector<int> vertices(std::max(count, 0));
+    std::cout << "Insira os vértices a visitar:\n";
+    for (auto &v : vertices) {
+        std::cin >> v;
+    }
+    std::cin.ignore();
+
+    int first;
+    std::cout << "Insira o vértice de partida:\n";
+    std::cin >> first;
+    std::cin.ignore();
+
+    std::vector<int> path;
+    auto start = std::chrono::high_resolution_clock::now();
+    double dist = routingOperations.tspSubset(graph, vertices, first, path);
+    auto end = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::duration<double>>(end - start).count();
+
+    if (path.empty()) {
+        cout << "The starting vertex is not in the graph." << std::endl;
+        return;
+    }
+
+    cout << "The distance is: " << dist << '\n';
+    cout << "The execution time is: " << duration << " seconds" << '\n';
+    cout << "The path is: ";
+    for (auto i : path) {
+        cout << i << " ";
+    }
+    cout << std::endl;
+
+    path.pop_back();
+    DynamicTour dynamicTour(graph, path);
+    while (true) {
+        int change, vertex;
+        std::cout << "Selecione uma das seguintes opções (0-2):\n";
+        std::cout << "1- Adicionar um vértice a visitar\n";
+        std::cout << "2- Remover um vértice a visitar\n";
+        std::cout << "0- Sair\n";
+        std::cin >> change;
+        std::cin.ignore();
+        if (change != 1 && change != 2) {
+            break;
+        }
+
+        std::cout << "Insira o vértice:\n";
+        std::cin >> vertex;
+        std::cin.ignore();
+
+        start = std::chrono::high_resolution_clock::now();
+        bool changed = change == 1 ? dynamicTour.insert(vertex) : dynamicTour.remove(vertex);
+        end = std::chrono::high_resolution_clock::now();
+        duration = std::chrono::duration_cast<std::chrono::duration<double>>(end - start).count();
+
+        if (!changed) {
+            cout << (change == 1 ? "The vertex is not in the graph or is already visited." : "The vertex is not visited.") << '\n';
+            continue;
+        }
+        cout << "The distance is: " << dynamicTour.getLength() << '\n';
+        cout << "The update time is: " << duration << " seconds" << '\n';
+        cout << "The path is: ";
+        for (auto i : dynamicTour.getPath()) {
+            cout << i << " ";
+        }
+        cout << std::endl;
+    }
+}
+
+void Menu::edgeUpdatesMenu() {
+    auto start = std::chrono::high_resolution_clock::now();
+    DynamicMST mst(graph);
+    auto end = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::duration<double>>(end - start).count();
+
+    cout << "The MST weight is: " << mst.getWeight() << '\n';
+    cout << "The build time is: " << duration << " seconds" << '\n';
+
+    while (true) {
+        int change;
+        std::cout << "Selecione uma das seguintes opções (0-4):\n";
+        std::cout << "1- Atualizar o peso de uma aresta\n";
+        std::cout << "2- Triangular Approximation (MST atual)\n";
+        std::cout << "3- Christofides Approximation (MST atual)\n";
+        std::cout << "4- Reconstruir a hierarquia de contração\n";
+        std::cout << "0- Sair\n";
+        std::cin >> change;
+        std::cin.ignore();
+
+        if (change == 1) {
+            int u, v;
+            double w;
+            std::cout << "Insira os dois vértices da aresta:\n";
+            std::cin >> u >> v;
+            std::cout << "Insira o novo peso:\n";
+            std::cin >> w;
+            std::cin.ignore();
+
+            start = std::chrono::high_resolution_clock::now();
+            bool changed = mst.update(u, v, w);
+            end = std::chrono::high_resolution_clock::now();
+            duration = std::chrono::duration_cast<std::chrono::duration<double>>(end - start).count();
+
+            if (!changed) {
+                cout << "There is no edge between the vertices." << '\n';
+                continue;
+            }
+            // the bound was computed with the old weights
+            lowerBound = -1;
+            cout << "The MST weight is: " << mst.getWeight() << '\n';
+            cout << "The update time is: " << duration << " seconds" << '\n';
+            cout << "The MST swaps so far: " << mst.getNumSwaps() << '\n';
+            if (graph->isHierarchyStale()) {
+                cout << "The contraction hierarchy is out of date, so the shortest path distances are computed by A* until it is rebuilt (option 4)." << '\n';
+            }
+        } else if (change == 2 || change == 3) {
+            Tour tour;
+            double matchingCost, matchingTime;
+            start = std::chrono::high_resolution_clock::now();
+            RootedTree tree = mst.getTree(0);
+            tour = change == 2 ? graph->tourTriangApproxTsp(tree) : graph->tourChristofidesApproxTsp(tree, exactMatching, matchingCost, matchingTime);
+            double dist = graph->getTourLength(tour);
+            end = std::chrono::high_resolution_clock::now();
+            duration = std::chrono::duration_cast<std::chrono::duration<double>>(end - start).count();
+
+            cout << "The distance is: " << dist << '\n';
+            cout << "The execution time is: " << duration << " seconds" << '\n';
+            cout << "The path is: ";
+            for (auto i : tour.getPath(0)) {
+                cout << i << " ";
+            }
+            cout << std::endl;
+        } else if (change == 4) {
+            if (!graph->isSparse()) {
+                cout << "The contraction hierarchy is only built for sparse graphs." << '\n';
+                continue;
+            }
+            start = std::chrono::high_resolution_clock::now();
+            bool built = graph->buildHierarchy();
+            end = std::chrono::high_resolution_clock::now();
+            duration = std::chrono::duration_cast<std::chrono::duration<double>>(end - start).count();
+
+            if (!built) {
+                cout << "The vertex IDs must be 0 to " << graph->getNumVertex() - 1 << '\n';
+                continue;
+            }
+            cout << "The build time is: " << duration << " seconds" << '\n';
+        } else {
+            break;
+        }
+    }
+}
@@ -10,9 +10,13 @@
 
 #include <iostream>
 #include <chrono>
+#include <iomanip>
+#include <string>
 
 #include "data_structures/Graph.h"
 #include "Routing.h"
+#include "DynamicTour.h"
+#include "data_structures/DynamicMST.h"
 
 enum GraphType{toyGraph, mediumGraph, realGraph, externGraph};
 
@@ -36,6 +40,7 @@ private:
 
     int option;
     bool quit = false;
+    double lowerBound = -1;
     /**
      * @brief Displays the menu options.
      */
@@ -60,6 +65,65 @@ private:
      * @brief Handles the menu for other heuristics.
      */
     void otherHeuristicsMenu();
+
+    /**
+     * @brief Handles the menu for the local search (2-opt + Or-opt or Lin-Kernighan) applied after a heuristic.
+     */
+    void localSearchMenu();
+
+    /**
+     * @brief Runs every heuristic, with and without each local search, and prints the distance, gap and runtime of each one.
+     *
+     * The gap is measured against the shortest tour in the table.
+     */
+    void resultsTableMenu();
+
+    /**
+     * @brief Handles the menu for the multi-threaded metaheuristics (iterated local search, genetic algorithm, ant colony and the portfolio of solvers), which run until a time limit.
+     */
+    void metaheuristicsMenu();
+
+    /**
+     * @brief Handles the menu for the shortest paths (Floyd-Warshall, one Dijkstra per vertex or bidirectional A* on demand), which replaces
+     * the distances used by the heuristics with the metric closure of the graph and shows the shortest path or distance between two vertices.
+     */
+    void shortestPathsMenu();
+
+    /**
+     * @brief Handles the menu for the TSP over a subset of the vertices, which reads the vertices to visit and the starting vertex
+     * and prints the distance and the path found. The vertices to visit can then be added or removed one at a time, and the
+     * tour is repaired around each change instead of being solved again.
+     */
+    void subsetMenu();
+
+    /**
+     * @brief Handles the menu for the edge weight updates, which keeps the minimum spanning tree of the graph while the
+     * weights of its edges change, and builds the Triangular and Christofides tours from the kept tree instead of running Prim's algorithm.
+     * The contraction hierarchy, which an update leaves stale, can be rebuilt from this menu.
+     */
+    void edgeUpdatesMenu();
+
+    /**
+     * @brief Runs one of the heuristics selected by the user.
+     * @param heuristic 1 for the Triangular Approximation, 2 for the Heuristic Approximation, 3 for the Christofides Approximation, 4 for the Greedy Edge,
+     * 5 for the Hilbert Curve, 6 for the Cheapest Insertion, 7 for the Farthest Insertion, 8 for the Nearest Insertion and 9 for the Clarke-Wright Savings.
+     * @param tour The tour found by the heuristic.
+     * @return The distance of the tour.
+     */
+    double runHeuristic(int heuristic, Tour &tour);
+
+    /**
+     * @brief Returns the Held-Karp lower bound of the graph, which is computed on the first call and then reused.
+     * @param upperBound The length of a known tour, used to compute the bound on the first call.
+     * @return The lower bound, or -1 if the graph is too large to have a distance matrix.
+     */
+    double getLowerBound(double upperBound);
+
+    /**
+     * @brief Prints the Held-Karp lower bound and how far the distance of a tour can be from the optimum.
+     * @param dist The distance of the tour.
+     */
+    void printGap(double dist);
 };
 
 #endif
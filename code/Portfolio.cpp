@@ -0,0 +1,212 @@
+#include "Portfolio.h"
+
+#define EPSILON 1e-7
+
+std::mutex Portfolio::throughputMutex;
+std::unordered_map<std::string, double> Portfolio::throughput;
+
+Portfolio::Portfolio(Graph *graph, unsigned int threads): graph(graph), view(graph), threads(threads), stop(false) {
+    if (this->threads == 0) {
+        this->threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+}
+
+bool Portfolio::isOptimal() const {
+    return optimal;
+}
+
+const std::vector<Portfolio::SolverStats> &Portfolio::getStats() const {
+    return stats;
+}
+
+void Portfolio::publish(const Tour &tour, double length, bool proven) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (optimal) {
+        return;
+    }
+    if (proven || length < bestLength - EPSILON) {
+        bestLength = length;
+        bestOrder = tour.toVector(0);
+    }
+    if (proven) {
+        optimal = true;
+        stop = true;
+        stopped.notify_all();
+    }
+}
+
+bool Portfolio::dynamicProgramming(Tour &tour, std::chrono::steady_clock::time_point deadline) const {
+    int n = view.size();
+    if (n <= 3) {
+        std::vector<int> order;
+        for (int c = 0; c < n; c++) order.push_back(c);
+        tour = Tour(order);
+        return true;
+    }
+
+    // cost[mask * m + j] is the shortest path from city 0 through the cities of mask (bit j is city j + 1) ending at city j + 1
+    int m = n - 1;
+    std::size_t full = (std::size_t) 1 << m;
+    std::vector<double> cost(full * m, INF);
+    std::vector<signed char> previous(full * m, -1);
+    for (int j = 0; j < m; j++) {
+        cost[((std::size_t) 1 << j) * m + j] = view.distance(0, j + 1);
+    }
+
+    for (std::size_t mask = 1; mask < full; mask++) {
+        if ((mask & 1023) == 0 && (stop || std::chrono::steady_clock::now() >= deadline)) {
+            return false;
+        }
+        for (int j = 0; j < m; j++) {
+            double c = cost[mask * m + j];
+            if (!(mask >> j & 1) || c == INF) continue;
+            for (int k = 0; k < m; k++) {
+                if (mask >> k & 1) continue;
+                std::size_t next = (mask | (std::size_t) 1 << k) * m + k;
+                double d = c + view.distance(j + 1, k + 1);
+                if (d < cost[next]) {
+                    cost[next] = d;
+                    previous[next] = (signed char) j;
+                }
+            }
+        }
+    }
+
+    int last = 0;
+    for (int j = 1; j < m; j++) {
+        if (cost[(full - 1) * m + j] + view.distance(j + 1, 0) < cost[(full - 1) * m + last] + view.distance(last + 1, 0)) {
+            last = j;
+        }
+    }
+
+    std::vector<int> order;
+    for (std::size_t mask = full - 1; last >= 0; ) {
+        order.push_back(last + 1);
+        int before = previous[mask * m + last];
+        mask &= ~((std::size_t) 1 << last);
+        last = before;
+    }
+    order.push_back(0);
+    std::reverse(order.begin(), order.end());
+    tour = Tour(order);
+    return true;
+}
+
+double Portfolio::solve(Tour &tour, double timeLimit) {
+    int n = view.size();
+    stats.clear();
+    optimal = false;
+    stop = false;
+    bestLength = INF;
+    bestOrder.clear();
+    if (n == 0) {
+        tour = Tour();
+        return 0;
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+    auto deadline = begin + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(timeLimit));
+
+    struct Solver {
+        std::string name;
+        double units;                           // work for this graph, in the units of its throughput
+        int maxVertices;                        // launch limit, whatever the throughput
+        bool cancellable;                       // stops by itself at the deadline, so its throughput does not matter
+        std::function<bool(Tour &)> run;        // false if the solver was stopped, leaving the tour found so far or none
+    };
+
+    // the greedy edge tour is the start of both Lin-Kernighan and the iterated local search, so it is built once
+    Tour greedy = graph->tourGreedyEdgeTsp();
+    std::vector<Solver> solvers = {
+        {"Held-Karp DP", std::ldexp((double) n * n, n), PORTFOLIO_EXACT_VERTICES, true, [&](Tour &t) {
+            return dynamicProgramming(t, deadline);
+        }},
+        {"Christofides + 2-opt/Or-opt", (double) n * n * n, PORTFOLIO_CHRISTOFIDES_VERTICES, false, [&](Tour &t) {
+            t = graph->tourChristofidesApproxTsp(0);
+            LocalSearch localSearch(view);
+            localSearch.optimize(t, &stop);
+            return !stop;
+        }},
+        {"Greedy Edge + Lin-Kernighan", (double) n * n, INT_MAX, true, [&](Tour &t) {
+            t = greedy;
+            LinKernighan linKernighan(view);
+            linKernighan.optimize(t, &stop);
+            return !stop;
+        }},
+    };
+
+    std::thread timer([this, deadline]() {
+        std::unique_lock<std::mutex> lock(mutex);
+        stopped.wait_until(lock, deadline, [this]() { return stop.load(); });
+        stop = true;
+    });
+
+    // the solvers that cannot be stopped are only launched if they are expected to finish before the deadline, or on small
+    // graphs until they are measured
+    std::vector<std::thread> pool;
+    stats.resize(solvers.size() + 1);
+    for (unsigned int i = 0; i < solvers.size(); i++) {
+        Solver &solver = solvers[i];
+        SolverStats &solverStats = stats[i];
+        solverStats.name = solver.name;
+        if (n > solver.maxVertices) continue;
+        {
+            std::lock_guard<std::mutex> lock(throughputMutex);
+            auto it = throughput.find(solver.name);
+            if (it != throughput.end()) solverStats.predicted = solver.units / it->second;
+        }
+        if (solverStats.predicted < 0) {
+            solverStats.launched = solver.cancellable || n <= PORTFOLIO_UNMEASURED_VERTICES;
+        } else {
+            solverStats.launched = solver.cancellable || solverStats.predicted <= timeLimit;
+        }
+        if (!solverStats.launched) continue;
+
+        pool.emplace_back([this, &solver, &solverStats, i]() {
+            auto start = std::chrono::steady_clock::now();
+            Tour t;
+            solverStats.finished = solver.run(t);
+            solverStats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            if (t.empty()) return;
+
+            // a stopped search still leaves a valid tour, but its time says nothing about the throughput
+            solverStats.length = view.tourLength(t);
+            publish(t, solverStats.length, i == 0 && solverStats.finished);
+            if (solverStats.finished && solverStats.seconds >= PORTFOLIO_MIN_MEASURED_TIME) {
+                std::lock_guard<std::mutex> lock(throughputMutex);
+                throughput[solver.name] = solver.units / solverStats.seconds;
+            }
+        });
+    }
+
+    // the iterated local search takes the threads left and only stops at the deadline or when the optimum is known
+    SolverStats &ilsStats = stats.back();
+    ilsStats.name = "Iterated Local Search";
+    ilsStats.launched = true;
+    ilsStats.predicted = timeLimit;
+    unsigned int ilsThreads = std::max(1u, threads - std::min(threads, (unsigned int) pool.size()));
+    {
+        auto start = std::chrono::steady_clock::now();
+        Tour t = greedy;
+        IteratedLocalSearch iteratedLocalSearch(view, ilsThreads);
+        double remaining = std::chrono::duration<double>(deadline - std::chrono::steady_clock::now()).count();
+        ilsStats.length = iteratedLocalSearch.optimize(t, std::max(0.0, remaining), &stop);
+        ilsStats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        ilsStats.finished = true;
+        publish(t, ilsStats.length, false);
+    }
+
+    // the timer stops the searches still running at the deadline, and is woken up here if they all ended before it
+    for (auto &t : pool) {
+        t.join();
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop = true;
+        stopped.notify_all();
+    }
+    timer.join();
+
+    tour = Tour(bestOrder);
+    return bestLength;
+}
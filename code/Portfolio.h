@@ -0,0 +1,129 @@
+#ifndef ROUTING_ALGORITHM_PORTFOLIO_H
+#define ROUTING_ALGORITHM_PORTFOLIO_H
+
+/**
+* @file Portfolio.h
+* @brief Contains the declaration of the Portfolio class.
+* @author Luiz, Pedro e Raphael
+* @date 02/06/2023
+*/
+
+#include <vector>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <unordered_map>
+#include <climits>
+#include <cmath>
+
+#include "data_structures/Graph.h"
+#include "data_structures/DistanceView.h"
+#include "data_structures/Tour.h"
+#include "LocalSearch.h"
+#include "LinKernighan.h"
+#include "IteratedLocalSearch.h"
+
+#define PORTFOLIO_EXACT_VERTICES 18
+#define PORTFOLIO_CHRISTOFIDES_VERTICES 2000
+#define PORTFOLIO_UNMEASURED_VERTICES 500
+#define PORTFOLIO_MIN_MEASURED_TIME 0.01
+
+/**
+ * @class Portfolio
+ * @brief Races several TSP solvers on their own threads and keeps the shortest tour found before the deadline.
+ *
+ * The portfolio runs the exact Held-Karp dynamic programming on graphs with at most PORTFOLIO_EXACT_VERTICES vertices,
+ * Christofides followed by 2-opt + Or-opt, the greedy edge tour followed by Lin-Kernighan, and an iterated local search
+ * on the remaining threads until the deadline. When the exact solver finishes the tour is optimal and the iterated local
+ * search is stopped at once.
+ *
+ * The local searches are stopped at the deadline and keep the moves applied so far, but the Christofides construction
+ * cannot be interrupted, so it is only launched if it is expected to finish in time: the throughput of every solver
+ * (work units per second, where a graph with n vertices takes n^2 units for the greedy edge tour with Lin-Kernighan and n^3
+ * for Christofides) is measured every time it finishes in at least PORTFOLIO_MIN_MEASURED_TIME seconds, below which the
+ * fixed costs would dominate, and predicts its time on the following calls while the program runs. A timer thread sets
+ * the stop flag of all the searches at the deadline. Until it has been
+ * measured it is only launched up to PORTFOLIO_UNMEASURED_VERTICES vertices. The greedy edge tour is built once, and both
+ * Lin-Kernighan and the iterated local search start from it.
+ */
+class Portfolio {
+public:
+    /**
+    * @brief The outcome of one solver in the last call to solve().
+    */
+    struct SolverStats {
+        std::string name;
+        bool launched = false;
+        bool finished = false;      // false if the solver was not launched, or was stopped before its search ended
+        double predicted = -1;      // expected time in seconds, or -1 if the solver was never measured
+        double seconds = 0;
+        double length = 0;
+    };
+
+    /**
+    * @brief Constructs a Portfolio object, building the distance matrix of the graph if it is small enough.
+    * @param graph The graph.
+    * @param threads The number of threads, or 0 to use one per hardware thread.
+    * @complexity O(n^2) to build the distance matrix, see DistanceView.
+    */
+    Portfolio(Graph *graph, unsigned int threads = 0);
+
+    /**
+    * @brief Runs the solvers until the deadline, or until the exact solver finishes.
+    *
+    * @param tour[out] The shortest tour found.
+    * @param timeLimit The wall-clock budget in seconds.
+    * @return The length of the shortest tour found.
+    * @complexity Bounded by the time limit, plus the greedy edge construction and a Christofides construction whose
+    * predicted time was wrong.
+    */
+    double solve(Tour &tour, double timeLimit);
+
+    /**
+    * @brief Checks if the tour of the last call to solve() was proven optimal by the exact solver.
+    */
+    bool isOptimal() const;
+
+    /**
+    * @brief Returns the outcome of every solver in the last call to solve().
+    */
+    const std::vector<SolverStats> &getStats() const;
+
+private:
+    Graph *graph;
+    DistanceView view;
+    unsigned int threads;
+
+    std::mutex mutex;
+    std::condition_variable stopped;        // wakes the timer that sets stop at the deadline
+    std::atomic<bool> stop;
+    std::vector<int> bestOrder;
+    double bestLength = 0;
+    bool optimal = false;
+    std::vector<SolverStats> stats;
+
+    // work units per second of every solver, measured by the previous runs
+    static std::mutex throughputMutex;
+    static std::unordered_map<std::string, double> throughput;
+
+    /**
+    * @brief Keeps the tour if it is the shortest so far, or always if it is optimal, in which case the other solvers are stopped.
+    */
+    void publish(const Tour &tour, double length, bool proven);
+
+    /**
+    * @brief Finds the shortest tour with the Held-Karp dynamic programming over the subsets of the cities.
+    *
+    * @param tour[out] The shortest tour.
+    * @param deadline The moment when the search gives up.
+    * @return True if the tour was found, false if the search was stopped or reached the deadline first.
+    * @complexity O(2^n * n^2) time and O(2^n * n) memory.
+    */
+    bool dynamicProgramming(Tour &tour, std::chrono::steady_clock::time_point deadline) const;
+};
+
+#endif
@@ -55,69 +55,270 @@ double Routing::tspBacktracking(Graph *graph) {
     return minDist;
 }
 
-double Routing::tspTriangApproximation(Graph *graph, std::vector<int> &path) {
-    double dist = 0;
-
-    std::vector<Vertex *> tour = graph->tourTriangApproxTsp(0);
-
-    path.push_back(0);
-    for (unsigned int i = 1; i < tour.size(); i++) {
-        path.push_back(tour[i]->getId());
-        if (tour[i]->getPath()->getOrig()->getId() == tour[i-1]->getId()) {
-            dist += tour[i]->getPath()->getWeight();
-        } else {
-            dist += tour[i-1]->getEdgeWeight(tour[i]);
+double Routing::tspTriangApproximation(Graph *graph, Tour &tour) {
+    tour = graph->tourTriangApproxTsp(0);
+    return graph->getTourLength(tour);
+}
+
+double Routing::TspHeuristicApprox(Graph *graph, Tour &tour) {
+    tour = graph->tourHeuristicApproxTsp(0);
+    return graph->getTourLength(tour);
+}
+
+double Routing::TspChristofidesApprox(Graph *graph, Tour &tour) {
+    tour = graph->tourChristofidesApproxTsp(0);
+    return graph->getTourLength(tour);
+}
+
+double Routing::TspChristofidesApprox(Graph *graph, Tour &tour, MatchingMethod method, double &matchingCost, double &matchingTime) {
+    tour = graph->tourChristofidesApproxTsp(0, method, matchingCost, matchingTime);
+    return graph->getTourLength(tour);
+}
+
+double Routing::tspMultiStart(Graph *graph, Tour &tour, int construction, int starts, const int &depot, unsigned int threads) {
+    int n = graph->getNumVertex();
+    if (graph->findVertex(depot) == nullptr) {
+        tour = Tour();
+        return 0;
+    }
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // the depot is always a start, followed by the other vertices in random order when only a sample is taken
+    std::vector<int> sources = {depot};
+    for (int v = 0; v < n; v++) {
+        if (v != depot) sources.push_back(v);
+    }
+    if (starts > 0 && starts < n) {
+        std::mt19937 rng(n);
+        std::shuffle(sources.begin() + 1, sources.end(), rng);
+        sources.resize(starts);
+    }
+
+    DistanceView view(graph);
+    std::atomic<int> nextSource(0);
+    std::mutex mutex;
+    double bestLength = INF;
+    int bestSource = n;
+    Tour best;
+
+    auto worker = [&]() {
+        for (int r = nextSource++; r < (int) sources.size(); r = nextSource++) {
+            Tour candidate = construction == 1 ? graph->tourTriangApproxTsp(sources[r]) : graph->tourHeuristicApproxTsp(sources[r]);
+            if (candidate.empty()) {
+                continue;
+            }
+            double length = view.tourLength(candidate);
+
+            // ties go to the earlier start, so the result does not depend on the number of threads
+            std::lock_guard<std::mutex> lock(mutex);
+            if (length < bestLength || (length == bestLength && r < bestSource)) {
+                bestLength = length;
+                bestSource = r;
+                best = std::move(candidate);
+            }
         }
+    };
+    std::vector<std::thread> pool;
+    for (unsigned int id = 1; id < threads; id++) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (auto &t : pool) {
+        t.join();
     }
 
-    path.push_back(0);
-    Vertex *final = graph->findVertex(path[graph->getNumVertex() - 1]);
-    dist += final->getEdgeWeight(tour[0]);
+    tour = Tour(best.toVector(depot));
+    return tour.empty() ? 0 : bestLength;
+}
 
-    return dist;
+double Routing::tspPartition(Graph *graph, Tour &tour, int cellSize, unsigned int threads) {
+    KarpPartition partition(graph, cellSize, threads);
+    return partition.solve(tour);
 }
 
-double Routing::TspHeuristicApprox(Graph *graph, std::vector<int> &path) {
-    double dist = 0;
+double Routing::tspGreedyEdge(Graph *graph, Tour &tour) {
+    tour = graph->tourGreedyEdgeTsp();
+    return graph->getTourLength(tour);
+}
 
-    std::vector<Vertex *> tour = graph->tourHeuristicApproxTsp(0);
+double Routing::tspHilbertCurve(Graph *graph, Tour &tour) {
+    tour = graph->tourHilbertTsp();
+    return graph->getTourLength(tour);
+}
 
-    path.push_back(0);
-    for (unsigned int i = 1; i < tour.size(); i++) {
-        path.push_back(tour[i]->getId());
-        if (tour[i]->getPath()->getOrig()->getId() == tour[i-1]->getId()) {
-            dist += tour[i]->getPath()->getWeight();
-        } else {
-            dist += tour[i-1]->getEdgeWeight(tour[i]);
-        }
+double Routing::tspCheapestInsertion(Graph *graph, Tour &tour) {
+    tour = graph->tourInsertionTsp(0, cheapestInsertion);
+    return graph->getTourLength(tour);
+}
+
+double Routing::tspFarthestInsertion(Graph *graph, Tour &tour) {
+    tour = graph->tourInsertionTsp(0, farthestInsertion);
+    return graph->getTourLength(tour);
+}
+
+double Routing::tspNearestInsertion(Graph *graph, Tour &tour) {
+    tour = graph->tourInsertionTsp(0, nearestInsertion);
+    return graph->getTourLength(tour);
+}
+
+double Routing::tspSavings(Graph *graph, Tour &tour) {
+    tour = graph->tourSavingsTsp(0);
+    return graph->getTourLength(tour);
+}
+
+double Routing::tspLocalSearch(Graph *graph, Tour &tour) {
+    if (tour.empty()) {
+        return 0;
     }
 
-    path.push_back(0);
-    Vertex *final = graph->findVertex(path[graph->getNumVertex() - 1]);
-    dist += final->getEdgeWeight(tour[0]);
+    DistanceView view(graph);
+    LocalSearch localSearch(view);
 
-    return dist;
+    return localSearch.optimize(tour);
 }
 
-double Routing::TspChristofidesApprox(Graph *graph, std::vector<int> &path) {
-    double dist = 0;
+double Routing::tspLinKernighan(Graph *graph, Tour &tour) {
+    if (tour.empty()) {
+        return 0;
+    }
 
-    std::vector<Vertex *> tour = graph->tourChristofidesApproxTsp(0);
+    DistanceView view(graph);
+    LinKernighan linKernighan(view);
 
-    path.push_back(0);
-    for (unsigned int i = 1; i < tour.size(); i++) {
-        path.push_back(tour[i]->getId());
-        if (tour[i]->getPath()->getOrig()->getId() == tour[i-1]->getId()) {
-            dist += tour[i]->getPath()->getWeight();
-        } else {
-            dist += tour[i-1]->getEdgeWeight(tour[i]);
+    return linKernighan.optimize(tour);
+}
+
+double Routing::tspLinKernighanAlpha(Graph *graph, Tour &tour, double timeLimit) {
+    if (tour.empty()) {
+        return 0;
+    }
+
+    DistanceView view(graph);
+    if (!view.isDense()) {
+        LinKernighan linKernighan(view, HK_ALPHA_CANDIDATES);
+        return linKernighan.optimize(tour);
+    }
+
+    HeldKarp heldKarp(view);
+    heldKarp.lowerBound(view.tourLength(tour), timeLimit);
+    LinKernighan linKernighan(view, heldKarp.alphaNearness(HK_ALPHA_CANDIDATES));
+
+    return linKernighan.optimize(tour);
+}
+
+double Routing::heldKarpBound(Graph *graph, double upperBound, double timeLimit, unsigned int threads) {
+    DistanceView view(graph);
+    if (!view.isDense()) {
+        return -1;
+    }
+
+    HeldKarp heldKarp(view, threads);
+    return heldKarp.lowerBound(upperBound, timeLimit);
+}
+
+Tour Routing::nearestNeighborTour(const DistanceView &view, int start) {
+    int n = view.size();
+    std::vector<bool> visited(n, false);
+    std::vector<int> order;
+    order.reserve(n);
+
+    for (int c = start; c >= 0; ) {
+        visited[c] = true;
+        order.push_back(c);
+        int next = -1;
+        for (int j = 0; j < n; j++) {
+            if (!visited[j] && (next < 0 || view.distance(c, j) < view.distance(c, next))) {
+                next = j;
+            }
         }
+        c = next;
+    }
+
+    return Tour(order);
+}
+
+double Routing::tspSubset(Graph *graph, const std::vector<int> &vertices, const int &start, std::vector<int> &path) {
+    path.clear();
+    if (graph->findVertex(start) == nullptr) {
+        return 0;
+    }
+
+    std::vector<int> ids = {start};
+    std::unordered_set<int> seen = {start};
+    for (int v : vertices) {
+        if (graph->findVertex(v) != nullptr && seen.insert(v).second) {
+            ids.push_back(v);
+        }
+    }
+
+    // the start vertex is city 0 of the view
+    DistanceView view(graph, ids);
+    Tour tour = nearestNeighborTour(view, 0);
+    double length = view.tourLength(tour);
+    if (view.size() > 3) {
+        LinKernighan linKernighan(view);
+        length = linKernighan.optimize(tour);
     }
 
-    path.push_back(0);
-    Vertex *final = graph->findVertex(path[graph->getNumVertex() - 1]);
-    dist += final->getEdgeWeight(tour[0]);
+    for (int c : tour.getPath(0)) {
+        path.push_back(view.getVertex(c));
+    }
+    return length;
+}
+
+double Routing::tspIteratedLocalSearch(Graph *graph, Tour &tour, double timeLimit, unsigned int threads) {
+    if (tour.empty()) {
+        return 0;
+    }
+
+    DistanceView view(graph);
+    IteratedLocalSearch iteratedLocalSearch(view, threads);
+
+    return iteratedLocalSearch.optimize(tour, timeLimit);
+}
+
+double Routing::tspGeneticAlgorithm(Graph *graph, Tour &tour, double timeLimit, unsigned int islands) {
+    int n = graph->getNumVertex();
+    if (n == 0) {
+        tour = Tour();
+        return 0;
+    }
+
+    DistanceView view(graph);
+    GeneticAlgorithm geneticAlgorithm(view, islands);
 
+    std::mt19937 rng(n);
+    std::vector<Tour> seeds;
+    unsigned int count = std::min(2 * geneticAlgorithm.getIslands(), (unsigned int) GA_SEEDS);
+    for (unsigned int i = 0; i < count; i++) {
+        int source = i < 2 ? 0 : rng() % n;
+        seeds.push_back(i % 2 == 0 ? graph->tourHeuristicApproxTsp(source) : graph->tourTriangApproxTsp(source));
+    }
+
+    return geneticAlgorithm.optimize(seeds, tour, timeLimit);
+}
+
+double Routing::tspAntColony(Graph *graph, Tour &tour, double timeLimit, unsigned int threads, std::vector<std::pair<double, double>> &history) {
+    if (graph->getNumVertex() == 0) {
+        tour = Tour();
+        history.clear();
+        return 0;
+    }
+
+    DistanceView view(graph);
+    AntColony antColony(view, threads);
+
+    double dist = antColony.optimize(tour, timeLimit);
+    history = antColony.getHistory();
     return dist;
 }
 
+double Routing::tspPortfolio(Graph *graph, Tour &tour, double timeLimit, unsigned int threads, bool &optimal, std::vector<Portfolio::SolverStats> &stats) {
+    Portfolio portfolio(graph, threads);
+    double dist = portfolio.solve(tour, timeLimit);
+    optimal = portfolio.isOptimal();
+    stats = portfolio.getStats();
+    return dist;
+}
@@ -10,12 +10,26 @@
 
 #include "data_structures/Graph.h"
 #include "data_structures/VertexEdge.h"
+#include "data_structures/DistanceView.h"
+#include "data_structures/Tour.h"
+#include "LocalSearch.h"
+#include "LinKernighan.h"
+#include "HeldKarp.h"
+#include "IteratedLocalSearch.h"
+#include "GeneticAlgorithm.h"
+#include "AntColony.h"
+#include "Portfolio.h"
+#include "KarpPartition.h"
 
 #include <iostream>
 #include <vector>
 #include <stack>
 #include <algorithm>
 #include <climits>
+#include <random>
+#include <unordered_set>
+#include <atomic>
+#include <mutex>
 
 /**
 @class Routing
@@ -47,14 +61,14 @@ public:
     /**
     * @brief Finds an approximate solution to the Traveling Salesman Problem (TSP) using the Triangulation algorithm. O((V + E) log V)
     * @param graph The graph representing the TSP instance.
-    * @param path[out] The approximate TSP path.
-    * @return The length of the approximate TSP path.
+    * @param tour[out] The approximate TSP tour.
+    * @return The length of the approximate TSP tour.
     *
     * This function uses the Triangulation algorithm to find an approximate solution to the TSP.
     * It constructs a minimum spanning tree of the graph and then performs a depth-first traversal to generate
     * a TSP path that visits each vertex exactly once.
     */
-    static double tspTriangApproximation(Graph *graph, std::vector<int> &path);
+    static double tspTriangApproximation(Graph *graph, Tour &tour);
 
     /**
     * Approximates the Traveling Salesman Problem (TSP) tour using a Heuristic Approximation Algorithm.
@@ -63,11 +77,11 @@ public:
     * selecting the nearest neighbor at each step.
     *
     * @param graph The graph representing the TSP problem.
-    * @param path A reference to a vector to store the TSP tour path.
+    * @param tour A reference to the tour where the TSP tour is stored.
     * @return The approximate distance of the TSP tour.
     * @complexity The time complexity of this function is O(n^2), where n is the number of vertices in the graph.
     */
-    static double TspHeuristicApprox(Graph *graph, std::vector<int> &path);
+    static double TspHeuristicApprox(Graph *graph, Tour &tour);
 
     /**
     * Approximates the Traveling Salesman Problem (TSP) tour using the Christofides Approximation Algorithm.
@@ -76,14 +90,278 @@ public:
     * spanning tree, finds a minimum-weight perfect matching of the odd-degree vertices, and combines them to form a tour.
     *
     * @param graph The graph representing the TSP problem.
-    * @param path A reference to a vector to store the TSP tour path.
+    * @param tour A reference to the tour where the TSP tour is stored.
     * @return The approximate distance of the TSP tour.
     * @complexity The time complexity of this function depends on the complexity of constructing the minimum spanning tree, finding a minimum-weight perfect matching, and combining them to form a tour, which is typically O(n^3), where n is the number of vertices in the graph.
     */
-    static double TspChristofidesApprox(Graph *graph, std::vector<int> &path);
+    static double TspChristofidesApprox(Graph *graph, Tour &tour);
+
+    /**
+    * Approximates the Traveling Salesman Problem (TSP) tour using the Christofides Approximation Algorithm with a chosen matching method.
+    *
+    * The exact matching (Edmonds' blossom algorithm) gives the 1.5 approximation guarantee, while the greedy matching over
+    * candidate lists improved with 2-opt style pair swaps is faster on graphs with many odd-degree vertices.
+    *
+    * @param graph The graph representing the TSP problem.
+    * @param tour A reference to the tour where the TSP tour is stored.
+    * @param method The algorithm used to match the odd-degree vertices of the minimum spanning tree.
+    * @param matchingCost[out] The total distance of the matched pairs.
+    * @param matchingTime[out] The time taken by the matching, in seconds.
+    * @return The approximate distance of the TSP tour.
+    * @complexity O(n^2 + k^3) with the exact matching and O(n^2 + k^2) with the greedy matching, where k is the number of odd-degree vertices.
+    */
+    static double TspChristofidesApprox(Graph *graph, Tour &tour, MatchingMethod method, double &matchingCost, double &matchingTime);
+
+    /**
+    * Runs the Triangular or the Heuristic Approximation from many start vertices in parallel and keeps the shortest tour.
+    *
+    * Both constructions give different tours from different roots of the minimum spanning tree. Every thread takes the next
+    * start vertex from a shared counter and builds its tour with its own scratch state, so only the best tour is shared.
+    *
+    * @param graph The graph representing the TSP problem.
+    * @param tour[out] The shortest tour found, starting at the depot.
+    * @param construction 1 for the Triangular Approximation, 2 for the Heuristic Approximation.
+    * @param starts The number of start vertices, the depot and a random sample of the others, or 0 to start from every vertex.
+    * @param depot The ID of the vertex where the tour has to start.
+    * @param threads The number of threads, or 0 to use one per hardware thread.
+    * @return The length of the shortest tour.
+    * @complexity O(s * |V|^2 / t), where s is the number of start vertices and t the number of threads.
+    */
+    static double tspMultiStart(Graph *graph, Tour &tour, int construction, int starts, const int &depot, unsigned int threads = 0);
+
+    /**
+    * Finds a TSP tour of a very large graph with coordinates by Karp's partitioning into cells solved in parallel.
+    *
+    * The vertices are split by a k-d tree into cells of at most cellSize vertices, each cell is solved on its own with
+    * Lin-Kernighan, and the tours of the cells are stitched together and repaired with 2-opt + Or-opt around the seams.
+    *
+    * @param graph The graph representing the TSP problem, whose vertices should have coordinates.
+    * @param tour[out] The TSP tour.
+    * @param cellSize The maximum number of vertices of a cell.
+    * @param threads The number of threads, or 0 to use one per hardware thread.
+    * @return The length of the tour.
+    * @complexity O(n * c) distance lookups spread over the threads plus O(n log n), where c is the size of the cells.
+    */
+    static double tspPartition(Graph *graph, Tour &tour, int cellSize = PARTITION_CELL_SIZE, unsigned int threads = 0);
+
+    /**
+    * Approximates the Traveling Salesman Problem (TSP) tour using the greedy-edge (multi-fragment) heuristic.
+    *
+    * This function repeatedly accepts the shortest edge of the graph that keeps every vertex with degree at most 2 and
+    * does not close a cycle, and then joins the resulting fragments. It is a fast starting tour for local search on large graphs.
+    *
+    * @param graph The graph representing the TSP problem.
+    * @param tour A reference to the tour where the TSP tour is stored.
+    * @return The approximate distance of the TSP tour.
+    * @complexity O(E log E + f^2), where E is the number of edges and f the number of fragments left by the greedy phase.
+    */
+    static double tspGreedyEdge(Graph *graph, Tour &tour);
+
+    /**
+    * Approximates the Traveling Salesman Problem (TSP) tour by visiting the vertices along a Hilbert space-filling curve.
+    *
+    * This function only uses the coordinates of the vertices, so it is meant for the real-world graphs. It is available in
+    * milliseconds even for a million vertices, either as a starting tour for local search or as a fallback when time is short.
+    *
+    * @param graph The graph representing the TSP problem.
+    * @param tour A reference to the tour where the TSP tour is stored.
+    * @return The approximate distance of the TSP tour.
+    * @complexity O(V) to build the tour, plus the computation of its distance.
+    */
+    static double tspHilbertCurve(Graph *graph, Tour &tour);
+
+    /**
+    * Approximates the Traveling Salesman Problem (TSP) tour using cheapest insertion.
+    *
+    * Starting from vertex 0, this function repeatedly inserts the vertex whose insertion increases the tour the least,
+    * keeping the cheapest insertion cost of every vertex in a priority queue updated with the edges that changed.
+    *
+    * @param graph The graph representing the TSP problem.
+    * @param tour A reference to the tour where the TSP tour is stored.
+    * @return The approximate distance of the TSP tour.
+    * @complexity O(n^2 log n), where n is the number of vertices in the graph.
+    */
+    static double tspCheapestInsertion(Graph *graph, Tour &tour);
+
+    /**
+    * Approximates the Traveling Salesman Problem (TSP) tour using farthest insertion.
+    *
+    * Starting from vertex 0, this function repeatedly inserts the vertex farthest from the tour where it increases the tour the least.
+    *
+    * @param graph The graph representing the TSP problem.
+    * @param tour A reference to the tour where the TSP tour is stored.
+    * @return The approximate distance of the TSP tour.
+    * @complexity O(n^2 log n), where n is the number of vertices in the graph.
+    */
+    static double tspFarthestInsertion(Graph *graph, Tour &tour);
+
+    /**
+    * Approximates the Traveling Salesman Problem (TSP) tour using nearest insertion.
+    *
+    * Starting from vertex 0, this function repeatedly inserts the vertex closest to the tour where it increases the tour the least.
+    *
+    * @param graph The graph representing the TSP problem.
+    * @param tour A reference to the tour where the TSP tour is stored.
+    * @return The approximate distance of the TSP tour.
+    * @complexity O(n^2 log n), where n is the number of vertices in the graph.
+    */
+    static double tspNearestInsertion(Graph *graph, Tour &tour);
+
+    /**
+    * Approximates the Traveling Salesman Problem (TSP) tour using the Clarke-Wright savings algorithm with vertex 0 as the depot.
+    *
+    * Routes through the depot are merged along the edges with the largest savings, which are streamed from the
+    * SAVINGS_CANDIDATES nearest neighbours of each vertex instead of sorting every pair, so it also fits the large real-world graphs.
+    *
+    * @param graph The graph representing the TSP problem.
+    * @param tour A reference to the tour where the TSP tour is stored.
+    * @return The approximate distance of the TSP tour.
+    * @complexity O(|E| + n * SAVINGS_CANDIDATES * log n + f^2), where f is the number of routes left when the candidates run out.
+    */
+    static double tspSavings(Graph *graph, Tour &tour);
+
+    /**
+    * Improves a TSP tour with 2-opt and Or-opt local search.
+    *
+    * This function takes the tour produced by tspTriangApproximation, TspHeuristicApprox or TspChristofidesApprox
+    * and applies 2-opt and Or-opt moves restricted to the nearest neighbours of each vertex, using don't-look bits
+    * to only revisit the vertices whose tour edges changed.
+    *
+    * @param graph The graph representing the TSP problem.
+    * @param tour A reference to the TSP tour. It is replaced by the improved tour.
+    * @return The distance of the improved TSP tour.
+    * @complexity Near-linear per pass over the tour, plus O(n^2) to build the distance matrix and the candidate lists on graphs with at most MAX_DENSE_VERTICES vertices.
+    */
+    static double tspLocalSearch(Graph *graph, Tour &tour);
+
+    /**
+    * Improves a TSP tour with a Lin-Kernighan style variable-depth search.
+    *
+    * This function takes the tour produced by any of the heuristics and repeatedly applies chains of up to
+    * LK_MAX_DEPTH sequential flips (moves of at most 5-opt) built from the nearest neighbours of each vertex.
+    *
+    * @param graph The graph representing the TSP problem.
+    * @param tour A reference to the TSP tour. It is replaced by the improved tour.
+    * @return The distance of the improved TSP tour.
+    * @complexity Each flip costs O(n) on the array tour (O(sqrt(n)) on the two-level list), and each vertex explores at most 8 * 5 * 3 * 2 chains per pass.
+    */
+    static double tspLinKernighan(Graph *graph, Tour &tour);
+
+    /**
+    * Improves a TSP tour with the Lin-Kernighan search of tspLinKernighan over alpha-nearness candidate lists.
+    *
+    * The penalties of the Held-Karp lower bound are computed first, starting from the length of the tour, and the
+    * HK_ALPHA_CANDIDATES candidates of each vertex are the edges that least grow the shortest penalized 1-tree.
+    * Graphs without a distance matrix fall back to the nearest neighbours.
+    *
+    * @param graph The graph representing the TSP problem.
+    * @param tour A reference to the TSP tour. It is replaced by the improved tour.
+    * @param timeLimit The wall-clock budget of the lower bound in seconds.
+    * @return The distance of the improved TSP tour.
+    * @complexity O(n^2) per subgradient iteration and O(n^2) for the candidate lists, plus the cost of tspLinKernighan.
+    */
+    static double tspLinKernighanAlpha(Graph *graph, Tour &tour, double timeLimit);
+
+    /**
+    * Computes the Held-Karp lower bound of the TSP, which is used to report how far a tour can be from the optimum.
+    *
+    * @param graph The graph representing the TSP problem.
+    * @param upperBound The length of a known tour.
+    * @param timeLimit The wall-clock budget in seconds.
+    * @param threads The number of subgradient chains, or 0 to use one per hardware thread.
+    * @return The lower bound, or -1 if the graph has more than MAX_DENSE_VERTICES vertices and no distance matrix.
+    * @complexity O(n^2) per iteration of each chain, bounded by HK_MAX_ITERATIONS and the time limit.
+    */
+    static double heldKarpBound(Graph *graph, double upperBound, double timeLimit, unsigned int threads = 0);
+
+    /**
+    * Solves the TSP over a subset of the vertices of the graph, starting and ending at a given vertex.
+    *
+    * The subset is solved over a DistanceView of its own vertices, so the graph is not copied and the memory and time depend
+    * on the size of the subset only: a nearest neighbour tour from the start vertex is improved with Lin-Kernighan.
+    *
+    * @param graph The graph with the vertices.
+    * @param vertices The IDs of the vertices to visit, in any order. Repeated IDs and IDs not in the graph are ignored.
+    * @param start The ID of the first and last vertex of the path, which is visited even if it is not in the list.
+    * @param path[out] The closed path, with the IDs of the vertices from start back to start.
+    * @return The distance of the path.
+    * @complexity O(k^2) distance lookups plus the cost of tspLinKernighan over k vertices, where k is the size of the subset.
+    */
+    static double tspSubset(Graph *graph, const std::vector<int> &vertices, const int &start, std::vector<int> &path);
+
+    /**
+    * Improves a TSP tour with multi-threaded iterated local search.
+    *
+    * Every thread applies random double-bridge kicks followed by 2-opt + Or-opt local search to a private copy of the tour,
+    * keeping the kicks that shorten it, and the threads periodically share the best tour found. It is meant to start
+    * from the tour of TspChristofidesApprox.
+    *
+    * @param graph The graph representing the TSP problem.
+    * @param tour A reference to the TSP tour. It is replaced by the best tour found.
+    * @param timeLimit The wall-clock budget in seconds.
+    * @param threads The number of threads, or 0 to use one per hardware thread.
+    * @return The distance of the best TSP tour found.
+    * @complexity Bounded by the time limit, plus O(n^2) to build the distance matrix and the candidate lists on graphs with at most MAX_DENSE_VERTICES vertices.
+    */
+    static double tspIteratedLocalSearch(Graph *graph, Tour &tour, double timeLimit, unsigned int threads = 0);
+
+    /**
+    * Finds a TSP tour with an island-model genetic algorithm using edge assembly crossover.
+    *
+    * The islands are seeded with up to GA_SEEDS runs of tourHeuristicApproxTsp and tourTriangApproxTsp from random
+    * source vertices, and each island evolves on its own thread, periodically sending its best tour to the next island.
+    *
+    * @param graph The graph representing the TSP problem.
+    * @param tour[out] The best TSP tour found.
+    * @param timeLimit The wall-clock budget of the evolution in seconds.
+    * @param islands The number of islands, or 0 to use one per hardware thread.
+    * @return The distance of the best TSP tour found.
+    * @complexity Bounded by the time limit, plus the GA_SEEDS constructions and O(n^2) to build the distance matrix and the candidate lists on graphs with at most MAX_DENSE_VERTICES vertices.
+    */
+    static double tspGeneticAlgorithm(Graph *graph, Tour &tour, double timeLimit, unsigned int islands = 0);
+
+    /**
+    * Finds a TSP tour with a parallel MAX-MIN ant colony restricted to the candidate edges of each vertex.
+    *
+    * The ants of each iteration are built in parallel and improved with 2-opt + Or-opt, and the pheromone of the
+    * candidate edges is reinforced with the iteration best or best-so-far tour.
+    *
+    * @param graph The graph representing the TSP problem.
+    * @param tour[out] The best TSP tour found.
+    * @param timeLimit The wall-clock budget in seconds.
+    * @param threads The number of threads, or 0 to use one per hardware thread.
+    * @param history[out] The time-to-quality curve: the elapsed seconds and the distance of every improvement of the best tour.
+    * @return The distance of the best TSP tour found.
+    * @complexity Bounded by the time limit, plus O(n^2) to build the distance matrix and the candidate lists on graphs with at most MAX_DENSE_VERTICES vertices.
+    */
+    static double tspAntColony(Graph *graph, Tour &tour, double timeLimit, unsigned int threads, std::vector<std::pair<double, double>> &history);
+
+    /**
+    * Races a portfolio of solvers on their own threads and returns the shortest tour at the deadline, or the optimal tour
+    * as soon as the exact Held-Karp dynamic programming finishes on graphs with at most PORTFOLIO_EXACT_VERTICES vertices.
+    *
+    * @param graph The graph representing the TSP problem.
+    * @param tour[out] The shortest TSP tour found.
+    * @param timeLimit The wall-clock budget in seconds.
+    * @param threads The number of threads, or 0 to use one per hardware thread.
+    * @param optimal[out] True if the tour is proven optimal.
+    * @param stats[out] The outcome of every solver: if it was launched, its predicted and actual time and its distance.
+    * @return The distance of the shortest TSP tour found.
+    * @complexity Bounded by the time limit, plus O(n^2) to build the distance matrix on graphs with at most MAX_DENSE_VERTICES vertices.
+    */
+    static double tspPortfolio(Graph *graph, Tour &tour, double timeLimit, unsigned int threads, bool &optimal, std::vector<Portfolio::SolverStats> &stats);
 
 private:
 
+    /**
+    * @brief Builds a tour by always moving to the closest city not visited yet.
+    * @param view The distances between the cities.
+    * @param start The first city.
+    * @return The tour.
+    * @complexity O(n^2)
+    */
+    static Tour nearestNeighborTour(const DistanceView &view, int start);
+
     /**
     * Recursive helper function for solving the Traveling Salesman Problem (TSP) using backtracking.
     *
@@ -0,0 +1,104 @@
+#include "BidirectionalAStar.h"
+
+#include <queue>
+#include <algorithm>
+
+BidirectionalAStar::BidirectionalAStar(const std::vector<Vertex *> &vertices): n(vertices.size()), vertices(vertices) {
+    for (int side = 0; side < 2; side++) {
+        offset[side].assign(n + 1, 0);
+        for (int v = 0; v < n; v++) {
+            offset[side][v + 1] = offset[side][v] + (side == 0 ? vertices[v]->getAdj() : vertices[v]->getIncoming()).size();
+        }
+        head[side].resize(offset[side][n]);
+        weight[side].resize(offset[side][n]);
+        for (int v = 0; v < n; v++) {
+            int p = offset[side][v];
+            for (auto e : side == 0 ? vertices[v]->getAdj() : vertices[v]->getIncoming()) {
+                head[side][p] = (side == 0 ? e->getDest() : e->getOrig())->getId();
+                weight[side][p++] = e->getWeight();
+            }
+        }
+    }
+}
+
+double BidirectionalAStar::distance(int s, int t) const {
+    if (s == t) {
+        return 0;
+    }
+
+    // scratch of the calling thread, grown to the largest graph queried and cleared after every query
+    thread_local std::vector<double> dist[2];
+    thread_local std::vector<double> potential;
+    thread_local std::vector<int> touched;
+    for (auto &d : dist) {
+        if ((int) d.size() < n) d.resize(n, INF);
+    }
+    if ((int) potential.size() < n) potential.resize(n, INF);
+
+    // the forward potential, computed when a vertex is first reached; the backward one is its negation
+    Vertex *source = vertices[s], *target = vertices[t];
+    auto forward = [&](int v) {
+        if (potential[v] == INF) {
+            potential[v] = (vertices[v]->haversine_distance(target) - vertices[v]->haversine_distance(source)) / 2;
+        }
+        return potential[v];
+    };
+
+    typedef std::pair<double, int> Entry;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue[2];
+    dist[0][s] = 0;
+    dist[1][t] = 0;
+    touched.push_back(s);
+    touched.push_back(t);
+    queue[0].push({forward(s), s});
+    queue[1].push({-forward(t), t});
+
+    double best = INF;
+    while (!queue[0].empty() && !queue[1].empty()) {
+        // stop once no path through the vertices left can be shorter than the best one
+        if (queue[0].top().first + queue[1].top().first >= best) {
+            break;
+        }
+
+        // expands the side with the smaller queue, which keeps both searches about the same size
+        int side = queue[0].size() <= queue[1].size() ? 0 : 1;
+        double sign = side == 0 ? 1 : -1;
+        Entry top = queue[side].top();
+        queue[side].pop();
+        int v = top.second;
+        if (top.first > dist[side][v] + sign * forward(v)) {
+            continue;
+        }
+
+        for (int p = offset[side][v]; p < offset[side][v + 1]; p++) {
+            int w = head[side][p];
+            double d = dist[side][v] + weight[side][p];
+            if (d < dist[side][w]) {
+                if (dist[0][w] == INF && dist[1][w] == INF) touched.push_back(w);
+                dist[side][w] = d;
+                queue[side].push({d + sign * forward(w), w});
+                if (dist[side ^ 1][w] != INF) {
+                    best = std::min(best, d + dist[side ^ 1][w]);
+                }
+            }
+        }
+    }
+
+    for (int v : touched) {
+        dist[0][v] = dist[1][v] = INF;
+        potential[v] = INF;
+    }
+    touched.clear();
+
+    return best;
+}
+
+void BidirectionalAStar::setWeight(int u, int v, double w) {
+    // the edge is among the outgoing edges of u and the incoming edges of v
+    for (int p = offset[0][u]; p < offset[0][u + 1]; p++) {
+        if (head[0][p] == v) weight[0][p] = w;
+    }
+    for (int p = offset[1][v]; p < offset[1][v + 1]; p++) {
+        if (head[1][p] == u) weight[1][p] = w;
+    }
+}
@@ -0,0 +1,62 @@
+#ifndef ROUTING_ALGORITHM_BIDIRECTIONAL_A_STAR_H
+#define ROUTING_ALGORITHM_BIDIRECTIONAL_A_STAR_H
+
+/**
+* @file BidirectionalAStar.h
+* @brief Contains the declaration of the BidirectionalAStar class.
+* @author Luiz, Pedro e Raphael
+* @date 02/06/2023
+*/
+
+#include <vector>
+
+#include "VertexEdge.h"
+
+/**
+ * @class BidirectionalAStar
+ * @brief Computes shortest path distances on demand with a bidirectional A* search guided by the haversine distance.
+ *
+ * The forward search uses the potential p(v) = (h(v, t) - h(v, s)) / 2 and the backward search its negation, where h is the
+ * haversine distance, so both searches see the same nonnegative reduced edge weights and can stop as soon as the sum of
+ * their smallest keys reaches the best path found. The result is exact as long as no edge is shorter than the haversine
+ * distance between its ends; without coordinates every potential is 0 and the search is a bidirectional Dijkstra.
+ */
+class BidirectionalAStar {
+public:
+    /**
+    * @brief Constructs a BidirectionalAStar object over the vertices of a graph.
+    * @param vertices The vertices of the graph, where vertices[i] has ID i.
+    * @complexity O(|V| + |E|)
+    */
+    explicit BidirectionalAStar(const std::vector<Vertex *> &vertices);
+
+    /**
+    * @brief Computes the shortest path distance between two vertices. Safe to call from several threads at once.
+    * @param s The source vertex.
+    * @param t The destination vertex.
+    * @return The distance, or INF if there is no path.
+    * @complexity O(k log k), where k is the number of vertices settled, usually a small part of the graph around the path.
+    */
+    double distance(int s, int t) const;
+
+    /**
+    * @brief Changes the weight of the edge from u to v in both searches, without building the compressed edges again.
+    * Not safe to call while another thread is computing a distance.
+    * @param u The origin of the edge.
+    * @param v The destination of the edge.
+    * @param w The new weight.
+    * @complexity O(deg(u) + deg(v))
+    */
+    void setWeight(int u, int v, double w);
+
+private:
+    int n;
+    std::vector<Vertex *> vertices;
+
+    // outgoing (forward) and incoming (backward) edges in compressed form
+    std::vector<int> offset[2];
+    std::vector<int> head[2];
+    std::vector<double> weight[2];
+};
+
+#endif
@@ -0,0 +1,319 @@
+#include "ContractionHierarchy.h"
+
+#include <algorithm>
+#include <limits>
+#include <queue>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+
+namespace {
+    const double UNREACHED = std::numeric_limits<double>::max();
+
+    typedef std::pair<double, int> Entry;
+    typedef std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> MinQueue;
+
+    /*
+     * The working graph of the contraction: adjacency lists of the vertices not contracted yet, with the scratch of the witness searches.
+     */
+    struct Contraction {
+        std::vector<std::vector<std::pair<int, double>>> adj;
+        std::vector<double> dist;
+        std::vector<int> touched;
+
+        /*
+         * Adds the edge {u, v}, or shortens it if it already exists.
+         */
+        void addEdge(int u, int v, double w) {
+            for (int side = 0; side < 2; side++, std::swap(u, v)) {
+                auto it = std::find_if(adj[u].begin(), adj[u].end(), [v](const std::pair<int, double> &e) { return e.first == v; });
+                if (it == adj[u].end()) adj[u].push_back({v, w});
+                else it->second = std::min(it->second, w);
+            }
+        }
+
+        /*
+         * Dijkstra from u that avoids the vertex being contracted, up to the distance limit or a number of settled vertices.
+         * Leaves the distances in dist, to be cleared by reset.
+         */
+        void witnessSearch(int u, int avoid, double limit, int maxSettled) {
+            MinQueue queue;
+            dist[u] = 0;
+            touched.push_back(u);
+            queue.push({0, u});
+            for (int settled = 0; !queue.empty() && settled < maxSettled; settled++) {
+                Entry top = queue.top();
+                queue.pop();
+                if (top.first > dist[top.second]) continue;
+                if (top.first > limit) break;
+                for (auto &e : adj[top.second]) {
+                    if (e.first == avoid) continue;
+                    double d = top.first + e.second;
+                    if (d < dist[e.first]) {
+                        if (dist[e.first] == UNREACHED) touched.push_back(e.first);
+                        dist[e.first] = d;
+                        queue.push({d, e.first});
+                    }
+                }
+            }
+        }
+
+        void reset() {
+            for (int v : touched) dist[v] = UNREACHED;
+            touched.clear();
+        }
+
+        /*
+         * Finds the shortcuts needed to contract v, adding them if apply is set, and returns how many there are.
+         * The priorities only estimate the shortcuts, with shorter witness searches than the actual contraction.
+         */
+        int contract(int v, bool apply) {
+            int maxSettled = apply ? CH_WITNESS_SETTLED : CH_WITNESS_SETTLED / 10;
+            int count = 0;
+            auto &neighbours = adj[v];
+            for (unsigned int a = 0; a < neighbours.size(); a++) {
+                int u = neighbours[a].first;
+                double limit = 0;
+                for (unsigned int b = a + 1; b < neighbours.size(); b++) {
+                    limit = std::max(limit, neighbours[a].second + neighbours[b].second);
+                }
+                if (a + 1 == neighbours.size()) break;
+
+                witnessSearch(u, v, limit, maxSettled);
+                for (unsigned int b = a + 1; b < neighbours.size(); b++) {
+                    double through = neighbours[a].second + neighbours[b].second;
+                    if (dist[neighbours[b].first] > through) {
+                        count++;
+                        if (apply) shortcuts.push_back({u, neighbours[b].first, through});
+                    }
+                }
+                reset();
+            }
+            return count;
+        }
+
+        std::vector<std::tuple<int, int, double>> shortcuts;
+    };
+}
+
+ContractionHierarchy::ContractionHierarchy() = default;
+
+ContractionHierarchy::ContractionHierarchy(int n, const std::vector<std::tuple<int, int, double>> &edges): n(n) {
+    Contraction graph;
+    graph.adj.resize(n);
+    graph.dist.assign(n, UNREACHED);
+    for (auto &e : edges) {
+        if (std::get<0>(e) != std::get<1>(e)) {
+            graph.addEdge(std::get<0>(e), std::get<1>(e), std::get<2>(e));
+        }
+    }
+
+    // the priority of a vertex is its edge difference (shortcuts added minus edges removed) plus its contracted neighbours,
+    // which spreads the contraction evenly over the graph; the neighbours of a contracted vertex get their priority updated,
+    // and the others are only checked again when they reach the top (lazy updates)
+    std::vector<int> deleted(n, 0), level(n, 0), key(n);
+    std::vector<bool> contracted(n, false);
+    auto priority = [&](int v) {
+        return 2 * (graph.contract(v, false) - (int) graph.adj[v].size()) + deleted[v] + level[v];
+    };
+    std::priority_queue<std::pair<int, int>, std::vector<std::pair<int, int>>, std::greater<std::pair<int, int>>> order;
+    for (int v = 0; v < n; v++) {
+        key[v] = priority(v);
+        order.push({key[v], v});
+    }
+
+    std::vector<std::vector<std::pair<int, double>>> up(n);
+    while (!order.empty()) {
+        int v = order.top().second;
+        if (contracted[v] || order.top().first != key[v]) {
+            order.pop();
+            continue;
+        }
+        order.pop();
+        key[v] = priority(v);
+        if (!order.empty() && key[v] > order.top().first) {
+            order.push({key[v], v});
+            continue;
+        }
+
+        graph.shortcuts.clear();
+        graph.contract(v, true);
+        shortcuts += graph.shortcuts.size();
+        contracted[v] = true;
+
+        // the neighbours left are contracted later, so these are the upward edges of v
+        up[v] = graph.adj[v];
+        for (auto &e : graph.adj[v]) {
+            auto &list = graph.adj[e.first];
+            list.erase(std::find_if(list.begin(), list.end(), [v](const std::pair<int, double> &f) { return f.first == v; }));
+            deleted[e.first]++;
+            level[e.first] = std::max(level[e.first], level[v] + 1);
+        }
+        for (auto &s : graph.shortcuts) {
+            graph.addEdge(std::get<0>(s), std::get<1>(s), std::get<2>(s));
+        }
+        for (auto &e : up[v]) {
+            key[e.first] = priority(e.first);
+            order.push({key[e.first], e.first});
+        }
+        graph.adj[v].clear();
+        graph.adj[v].shrink_to_fit();
+    }
+
+    offset.assign(n + 1, 0);
+    for (int v = 0; v < n; v++) {
+        offset[v + 1] = offset[v] + up[v].size();
+    }
+    head.resize(offset[n]);
+    weight.resize(offset[n]);
+    for (int v = 0; v < n; v++) {
+        int p = offset[v];
+        for (auto &e : up[v]) {
+            head[p] = e.first;
+            weight[p++] = e.second;
+        }
+    }
+}
+
+int ContractionHierarchy::size() const {
+    return n;
+}
+
+int ContractionHierarchy::getNumShortcuts() const {
+    return shortcuts;
+}
+
+double ContractionHierarchy::distance(int s, int t) const {
+    if (s == t) {
+        return 0;
+    }
+
+    // scratch of the calling thread, grown to the largest hierarchy queried and cleared after every query
+    thread_local std::vector<double> dist[2];
+    thread_local std::vector<int> touched;
+    for (auto &d : dist) {
+        if ((int) d.size() < n) d.resize(n, UNREACHED);
+    }
+
+    MinQueue queue[2];
+    dist[0][s] = 0;
+    dist[1][t] = 0;
+    touched.push_back(s);
+    touched.push_back(t);
+    queue[0].push({0, s});
+    queue[1].push({0, t});
+
+    double best = UNREACHED;
+    for (int side = 0; !queue[0].empty() || !queue[1].empty(); side ^= 1) {
+        if (queue[side].empty()) continue;
+        Entry top = queue[side].top();
+        queue[side].pop();
+        if (top.first > dist[side][top.second]) continue;
+
+        // a side stops once its closest vertex cannot improve the best meeting point
+        if (top.first >= best) {
+            while (!queue[side].empty()) queue[side].pop();
+            continue;
+        }
+        int v = top.second;
+        if (dist[side ^ 1][v] != UNREACHED) {
+            best = std::min(best, top.first + dist[side ^ 1][v]);
+        }
+
+        // stall-on-demand: a vertex reached more cheaply through a higher vertex is not on a shortest upward path
+        bool stalled = false;
+        for (int p = offset[v]; p < offset[v + 1] && !stalled; p++) {
+            stalled = dist[side][head[p]] != UNREACHED && dist[side][head[p]] + weight[p] < top.first;
+        }
+        if (stalled) continue;
+
+        for (int p = offset[v]; p < offset[v + 1]; p++) {
+            double d = top.first + weight[p];
+            if (d < dist[side][head[p]]) {
+                if (dist[0][head[p]] == UNREACHED && dist[1][head[p]] == UNREACHED) touched.push_back(head[p]);
+                dist[side][head[p]] = d;
+                queue[side].push({d, head[p]});
+            }
+        }
+    }
+
+    for (int v : touched) {
+        dist[0][v] = dist[1][v] = UNREACHED;
+    }
+    touched.clear();
+
+    return best;
+}
+
+bool ContractionHierarchy::save(const std::string &filename, uint64_t key) const {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    file << "vertices,key,shortcuts\n" << n << ',' << key << ',' << shortcuts << '\n';
+    file << "origem,destino,distancia\n" << std::setprecision(17);
+    for (int v = 0; v < n; v++) {
+        for (int p = offset[v]; p < offset[v + 1]; p++) {
+            file << v << ',' << head[p] << ',' << weight[p] << '\n';
+        }
+    }
+
+    return file.good();
+}
+
+bool ContractionHierarchy::load(const std::string &filename, int n, uint64_t key) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    std::string line, word;
+    getline(file, line);
+    getline(file, line);
+    std::stringstream header(line);
+    int vertices = -1, count = 0;
+    uint64_t fileKey = 0;
+    if (getline(header, word, ',')) vertices = stoi(word);
+    if (getline(header, word, ',')) fileKey = stoull(word);
+    if (getline(header, word)) count = stoi(word);
+    if (vertices != n || fileKey != key) {
+        return false;
+    }
+    getline(file, line);
+
+    std::vector<std::tuple<int, int, double>> edges;
+    while (getline(file, line)) {
+        if (line.empty()) continue;
+        std::stringstream sstream(line);
+        int u, v;
+        getline(sstream, word, ',');
+        u = stoi(word);
+        getline(sstream, word, ',');
+        v = stoi(word);
+        getline(sstream, word);
+        if (u < 0 || u >= n || v < 0 || v >= n) return false;
+        edges.emplace_back(u, v, stod(word));
+    }
+
+    // the edges were saved grouped by their lower vertex
+    this->n = n;
+    shortcuts = count;
+    offset.assign(n + 1, 0);
+    for (auto &e : edges) {
+        offset[std::get<0>(e) + 1]++;
+    }
+    for (int v = 0; v < n; v++) {
+        offset[v + 1] += offset[v];
+    }
+    head.resize(edges.size());
+    weight.resize(edges.size());
+    std::vector<int> position(offset.begin(), offset.end() - 1);
+    for (auto &e : edges) {
+        int p = position[std::get<0>(e)]++;
+        head[p] = std::get<1>(e);
+        weight[p] = std::get<2>(e);
+    }
+
+    return true;
+}
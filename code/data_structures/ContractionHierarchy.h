@@ -0,0 +1,93 @@
+#ifndef ROUTING_ALGORITHM_CONTRACTION_HIERARCHY_H
+#define ROUTING_ALGORITHM_CONTRACTION_HIERARCHY_H
+
+/**
+* @file ContractionHierarchy.h
+* @brief Contains the declaration of the ContractionHierarchy class.
+* @author Luiz, Pedro e Raphael
+* @date 02/06/2023
+*/
+
+#include <vector>
+#include <string>
+#include <tuple>
+#include <cstdint>
+
+#define CH_WITNESS_SETTLED 500
+
+/**
+ * @class ContractionHierarchy
+ * @brief Answers shortest path distance queries on a sparse undirected graph with a bidirectional search over a contraction hierarchy.
+ *
+ * The vertices are contracted one at a time, the least important first (the ones whose removal adds the fewest shortcuts).
+ * Removing a vertex adds a shortcut between two of its neighbours unless a local witness search finds a path between them
+ * that is no longer. Every shortest path then has a shortest equivalent that only goes up in the order and then down, so a
+ * query runs Dijkstra upwards from both ends and only settles a few hundred vertices.
+ */
+class ContractionHierarchy {
+public:
+    /**
+    * @brief Constructs an empty hierarchy, to be filled by load.
+    * @complexity O(1)
+    */
+    ContractionHierarchy();
+
+    /**
+    * @brief Builds the hierarchy of an undirected graph.
+    * @param n The number of vertices, which are numbered 0 to n - 1.
+    * @param edges The edges of the graph as (u, v, weight), in any direction and possibly repeated.
+    * @complexity O(n * d^2 * CH_WITNESS_SETTLED log n) in the worst case, where d is the degree of the vertices when they are contracted.
+    */
+    ContractionHierarchy(int n, const std::vector<std::tuple<int, int, double>> &edges);
+
+    /**
+    * @brief Returns the number of vertices of the hierarchy.
+    * @complexity O(1)
+    */
+    int size() const;
+
+    /**
+    * @brief Returns the number of shortcuts added by the contraction.
+    * @complexity O(1)
+    */
+    int getNumShortcuts() const;
+
+    /**
+    * @brief Computes the shortest path distance between two vertices. Safe to call from several threads at once.
+    * @param s The first vertex.
+    * @param t The second vertex.
+    * @return The distance, or INF if there is no path.
+    * @complexity O(k log k), where k is the number of vertices above s and t in the hierarchy, usually a few hundred.
+    */
+    double distance(int s, int t) const;
+
+    /**
+    * @brief Saves the hierarchy to a csv file.
+    * @param filename The name of the file.
+    * @param key A number that identifies the graph (such as a checksum of its edges), checked by load.
+    * @return True if the file was written.
+    * @complexity O(n + m), where m is the number of edges of the hierarchy.
+    */
+    bool save(const std::string &filename, uint64_t key) const;
+
+    /**
+    * @brief Loads a hierarchy saved by save.
+    * @param filename The name of the file.
+    * @param n The expected number of vertices.
+    * @param key The expected key of the graph.
+    * @return True if the file exists and matches the number of vertices and the key, otherwise the hierarchy is left empty.
+    * @complexity O(n + m), where m is the number of edges of the hierarchy.
+    */
+    bool load(const std::string &filename, int n, uint64_t key);
+
+private:
+    int n = 0;
+    int shortcuts = 0;
+
+    // upward edges in compressed form: the edges of v go to vertices contracted after v
+    std::vector<int> offset;
+    std::vector<int> head;
+    std::vector<double> weight;
+};
+
+#endif
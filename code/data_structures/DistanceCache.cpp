@@ -0,0 +1,74 @@
+#include "DistanceCache.h"
+
+#include <algorithm>
+
+DistanceCache::DistanceCache(std::size_t capacity):
+    shardCapacity(std::max<std::size_t>(1, capacity / DISTANCE_CACHE_SHARDS)), shards(new Shard[DISTANCE_CACHE_SHARDS]) {}
+
+std::uint64_t DistanceCache::key(int a, int b) {
+    return (std::uint64_t) (std::uint32_t) a << 32 | (std::uint32_t) b;
+}
+
+DistanceCache::Shard &DistanceCache::shard(std::uint64_t key) const {
+    // mixes the bits of both vertices, so the pairs of one vertex do not all land in the same shard
+    std::uint64_t h = key * 0x9E3779B97F4A7C15ULL;
+    return shards[(h >> 59) % DISTANCE_CACHE_SHARDS];
+}
+
+bool DistanceCache::get(int a, int b, double &dist) {
+    std::uint64_t k = key(a, b);
+    Shard &s = shard(k);
+    std::lock_guard<std::mutex> lock(s.mutex);
+
+    auto it = s.index.find(k);
+    if (it == s.index.end()) {
+        s.misses++;
+        return false;
+    }
+    s.hits++;
+    s.order.splice(s.order.begin(), s.order, it->second);
+    dist = it->second->second;
+    return true;
+}
+
+void DistanceCache::put(int a, int b, double dist) {
+    std::uint64_t k = key(a, b);
+    Shard &s = shard(k);
+    std::lock_guard<std::mutex> lock(s.mutex);
+
+    auto it = s.index.find(k);
+    if (it != s.index.end()) {
+        it->second->second = dist;
+        s.order.splice(s.order.begin(), s.order, it->second);
+        return;
+    }
+
+    if (s.index.size() >= shardCapacity) {
+        s.index.erase(s.order.back().first);
+        s.order.pop_back();
+    }
+    s.order.emplace_front(k, dist);
+    s.index[k] = s.order.begin();
+}
+
+void DistanceCache::clear() {
+    for (int i = 0; i < DISTANCE_CACHE_SHARDS; i++) {
+        std::lock_guard<std::mutex> lock(shards[i].mutex);
+        shards[i].order.clear();
+        shards[i].index.clear();
+    }
+}
+
+std::pair<std::uint64_t, std::uint64_t> DistanceCache::getStats() const {
+    std::uint64_t hits = 0, misses = 0;
+    for (int i = 0; i < DISTANCE_CACHE_SHARDS; i++) {
+        std::lock_guard<std::mutex> lock(shards[i].mutex);
+        hits += shards[i].hits;
+        misses += shards[i].misses;
+    }
+    return {hits, misses};
+}
+
+std::size_t DistanceCache::getCapacity() const {
+    return shardCapacity * DISTANCE_CACHE_SHARDS;
+}
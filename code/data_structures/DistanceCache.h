@@ -0,0 +1,90 @@
+#ifndef ROUTING_ALGORITHM_DISTANCE_CACHE_H
+#define ROUTING_ALGORITHM_DISTANCE_CACHE_H
+
+/**
+* @file DistanceCache.h
+* @brief Contains the declaration of the DistanceCache class.
+* @author Luiz, Pedro e Raphael
+* @date 02/06/2023
+*/
+
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <mutex>
+#include <memory>
+#include <cstdint>
+
+#define DISTANCE_CACHE_CAPACITY 1000000
+#define DISTANCE_CACHE_SHARDS 16
+
+/**
+ * @class DistanceCache
+ * @brief A bounded least recently used cache of the distances between pairs of vertices, safe to use from several threads.
+ *
+ * The pairs are spread over DISTANCE_CACHE_SHARDS shards by a hash of the pair, each with its own lock and an equal share
+ * of the capacity, so threads that look up different pairs rarely wait for each other. When a shard is full, the pair it
+ * used least recently is evicted.
+ */
+class DistanceCache {
+public:
+    /**
+    * @brief Constructs an empty DistanceCache.
+    * @param capacity The maximum number of pairs kept.
+    * @complexity O(1)
+    */
+    explicit DistanceCache(std::size_t capacity = DISTANCE_CACHE_CAPACITY);
+
+    /**
+    * @brief Looks up the distance of a pair and marks the pair as recently used.
+    * @param a The first vertex.
+    * @param b The second vertex.
+    * @param dist[out] The distance, if the pair is in the cache.
+    * @return True if the pair is in the cache.
+    * @complexity O(1) on average.
+    */
+    bool get(int a, int b, double &dist);
+
+    /**
+    * @brief Stores the distance of a pair, evicting the least recently used pair of its shard if the shard is full.
+    * @param a The first vertex.
+    * @param b The second vertex.
+    * @param dist The distance from a to b.
+    * @complexity O(1) on average.
+    */
+    void put(int a, int b, double dist);
+
+    /**
+    * @brief Removes every pair, keeping the capacity and the number of hits and misses.
+    * @complexity O(c), where c is the number of pairs kept.
+    */
+    void clear();
+
+    /**
+    * @brief Returns the number of lookups that found their pair, and of those that did not.
+    * @complexity O(DISTANCE_CACHE_SHARDS)
+    */
+    std::pair<std::uint64_t, std::uint64_t> getStats() const;
+
+    /**
+    * @brief Returns the maximum number of pairs kept.
+    * @complexity O(1)
+    */
+    std::size_t getCapacity() const;
+
+private:
+    struct Shard {
+        std::mutex mutex;
+        std::list<std::pair<std::uint64_t, double>> order;   // most recently used first
+        std::unordered_map<std::uint64_t, std::list<std::pair<std::uint64_t, double>>::iterator> index;
+        std::uint64_t hits = 0, misses = 0;
+    };
+
+    std::size_t shardCapacity;
+    std::unique_ptr<Shard[]> shards;
+
+    static std::uint64_t key(int a, int b);
+    Shard &shard(std::uint64_t key) const;
+};
+
+#endif
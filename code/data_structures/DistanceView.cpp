@@ -0,0 +1,111 @@
+#include "DistanceView.h"
+
+DistanceView::DistanceView(Graph *graph): graph(graph), n(graph->getNumVertex()) {
+    if (!graph->hasDistMatrix() && n <= MAX_DENSE_VERTICES) {
+        graph->buildDistMatrix();
+    }
+}
+
+DistanceView::DistanceView(Graph *graph, const std::vector<int> &vertices, unsigned int threads): graph(graph), n(vertices.size()), vertices(vertices) {
+    for (int i = 0; i < n; i++) {
+        city[vertices[i]] = i;
+    }
+    if (n > MAX_DENSE_VERTICES) {
+        return;
+    }
+
+    matrix.resize((std::size_t) n * n);
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // with nothing to answer shortest path queries, one Dijkstra per vertex of the subset fills the whole matrix
+    if (!graph->hasDistMatrix() && !graph->hasHierarchy() && graph->getDistanceCache() == nullptr && graph->isSparse()) {
+        std::vector<std::vector<double>> rows = graph->getRoadDistances(vertices, threads);
+        if (!rows.empty()) {
+            for (int i = 0; i < n; i++) {
+                std::copy(rows[i].begin(), rows[i].end(), matrix.begin() + (std::size_t) i * n);
+            }
+            return;
+        }
+    }
+
+    // each thread fills every threads-th row, since the lookups may be shortest path queries
+    auto fill = [this](unsigned int first, unsigned int step) {
+        for (int i = first; i < n; i += step) {
+            for (int j = 0; j < n; j++) {
+                matrix[(std::size_t) i * n + j] = i == j ? 0 : this->graph->getDistance(this->vertices[i], this->vertices[j]);
+            }
+        }
+    };
+    std::vector<std::thread> pool;
+    for (unsigned int id = 1; id < threads; id++) {
+        pool.emplace_back(fill, id, threads);
+    }
+    fill(0, threads);
+    for (auto &t : pool) {
+        t.join();
+    }
+}
+
+int DistanceView::size() const {
+    return n;
+}
+
+bool DistanceView::isDense() const {
+    return vertices.empty() ? graph->hasDistMatrix() : !matrix.empty();
+}
+
+int DistanceView::getVertex(int city) const {
+    return vertices.empty() ? city : vertices[city];
+}
+
+double DistanceView::distance(int i, int j) const {
+    if (!matrix.empty()) {
+        return matrix[(std::size_t) i * n + j];
+    }
+    return graph->getDistance(getVertex(i), getVertex(j));
+}
+
+double DistanceView::tourLength(const Tour &tour) const {
+    double length = 0;
+    for (int c = 0; c < tour.size(); c++) {
+        length += distance(c, tour.next(c));
+    }
+    return length;
+}
+
+std::vector<std::vector<int>> DistanceView::nearestNeighbors(int k) const {
+    std::vector<std::vector<int>> neighbors(n);
+
+    for (int i = 0; i < n; i++) {
+        std::vector<int> &list = neighbors[i];
+
+        if (isDense()) {
+            for (int j = 0; j < n; j++) {
+                if (j != i) list.push_back(j);
+            }
+        } else if (vertices.empty()) {
+            for (auto e : graph->findVertex(i)->getAdj()) {
+                if (e->getDest()->getId() != i) list.push_back(e->getDest()->getId());
+            }
+        } else {
+            // only the neighbours in the graph that are also in the subset
+            for (auto e : graph->findVertex(vertices[i])->getAdj()) {
+                auto it = city.find(e->getDest()->getId());
+                if (it != city.end() && it->second != i) list.push_back(it->second);
+            }
+        }
+
+        auto closer = [this, i](int a, int b) {
+            return distance(i, a) < distance(i, b);
+        };
+        if ((int) list.size() > k) {
+            std::nth_element(list.begin(), list.begin() + k, list.end(), closer);
+            list.resize(k);
+        }
+        std::sort(list.begin(), list.end(), closer);
+    }
+
+    return neighbors;
+}
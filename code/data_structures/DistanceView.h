@@ -0,0 +1,115 @@
+#ifndef ROUTING_ALGORITHM_DISTANCE_VIEW_H
+#define ROUTING_ALGORITHM_DISTANCE_VIEW_H
+
+/**
+* @file DistanceView.h
+* @brief Contains the declaration of the DistanceView class.
+* @author Luiz, Pedro e Raphael
+* @date 02/06/2023
+*/
+
+#include <vector>
+#include <algorithm>
+#include <unordered_map>
+#include <thread>
+
+#include "Graph.h"
+#include "Tour.h"
+
+#define MAX_DENSE_VERTICES 5000
+
+/**
+ * @class DistanceView
+ * @brief Read-only view of the distances between the vertices of a graph, used by the tour improvement algorithms.
+ *
+ * Cities are numbered 0 to size() - 1. Over the whole graph they match the vertex IDs, and over a subset of the vertices
+ * city i is the i-th vertex of the subset (see getVertex).
+ */
+class DistanceView {
+public:
+    /**
+    * @brief Constructs a view over every vertex of the graph.
+    *
+    * Builds the distance matrix of the graph when it has at most MAX_DENSE_VERTICES vertices.
+    *
+    * @param graph The graph whose distances are viewed.
+    * @complexity O(|V|^2) when the distance matrix is built, O(1) otherwise.
+    */
+    explicit DistanceView(Graph *graph);
+
+    /**
+    * @brief Constructs a view over a subset of the vertices of the graph, without copying the graph.
+    *
+    * The distances between the vertices of the subset are read once with Graph::getDistance, in parallel rows, into a
+    * local matrix when the subset has at most MAX_DENSE_VERTICES vertices. Larger subsets read them on demand.
+    * A sparse graph without a distance matrix, hierarchy or cache fills the matrix with Graph::getRoadDistances instead,
+    * so the cities are joined by their shortest paths rather than by the haversine distance.
+    *
+    * @param graph The graph whose distances are viewed.
+    * @param vertices The distinct IDs of the vertices of the subset, where vertices[i] becomes city i.
+    * @param threads The number of threads that fill the matrix, or 0 to use one per hardware thread.
+    * @complexity O(k^2) lookups of Graph::getDistance, or k searches of Graph::getRoadDistances, and O(k^2) memory for the
+    * local matrix, where k is the size of the subset.
+    */
+    DistanceView(Graph *graph, const std::vector<int> &vertices, unsigned int threads = 0);
+
+    /**
+    * @brief Returns the number of cities in the view.
+    * @return The number of cities.
+    * @complexity O(1)
+    */
+    int size() const;
+
+    /**
+    * @brief Checks if the view has a distance matrix, so every distance is read in constant time.
+    * @return True if the distance matrix of the graph was built.
+    * @complexity O(1)
+    */
+    bool isDense() const;
+
+    /**
+    * @brief Returns the ID of the vertex of the graph that a city stands for.
+    * @param city The city.
+    * @return The vertex ID.
+    * @complexity O(1)
+    */
+    int getVertex(int city) const;
+
+    /**
+    * @brief Returns the distance between two cities.
+    * @param i The first city.
+    * @param j The second city.
+    * @return The distance between the two cities.
+    * @complexity O(1) with a distance matrix, see Graph::getDistance otherwise.
+    */
+    double distance(int i, int j) const;
+
+    /**
+    * @brief Computes the length of a closed tour.
+    * @param tour The tour.
+    * @return The length of the tour, including the edge back to the first city.
+    * @complexity O(n), where n is the number of cities in the tour.
+    */
+    double tourLength(const Tour &tour) const;
+
+    /**
+    * @brief Computes the k nearest cities of every city (the candidate lists used by local search).
+    *
+    * With a distance matrix every city is considered, otherwise only the neighbours in the graph.
+    *
+    * @param k The maximum number of candidates per city.
+    * @return For every city, its candidates sorted by increasing distance.
+    * @complexity O(n^2) with a distance matrix, O(|E| log |E|) otherwise.
+    */
+    std::vector<std::vector<int>> nearestNeighbors(int k) const;
+
+private:
+    Graph *graph;
+    int n;
+
+    std::vector<int> vertices;          // the vertex of every city, empty over the whole graph
+    std::unordered_map<int, int> city;  // the city of every vertex of the subset
+    std::vector<double> matrix;         // the local n x n distances of the subset, by rows
+};
+
+#endif
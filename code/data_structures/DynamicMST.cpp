@@ -0,0 +1,209 @@
+#include "DynamicMST.h"
+
+DynamicMST::DynamicMST(Graph *graph): graph(graph) {
+    int n = graph->getNumVertex();
+    incident.resize(n);
+    treeAdj.resize(n);
+    mark.assign(n, 0);
+    via.assign(n, -1);
+
+    for (int v = 0; v < n; v++) {
+        for (auto e : graph->findVertex(v)->getAdj()) {
+            int w = e->getDest()->getId();
+            if (w == v || index.count(key(v, w))) {
+                continue;
+            }
+            index[key(v, w)] = edges.size();
+            incident[v].push_back(edges.size());
+            incident[w].push_back(edges.size());
+            edges.push_back({v, w, e->getWeight()});
+        }
+    }
+
+    // Kruskal's algorithm, the only time the whole tree is built
+    std::vector<int> sorted(edges.size());
+    for (unsigned int e = 0; e < edges.size(); e++) {
+        sorted[e] = e;
+    }
+    std::sort(sorted.begin(), sorted.end(), [this](int a, int b) {
+        return edges[a].weight < edges[b].weight;
+    });
+    UFDS ufds(n);
+    for (int e : sorted) {
+        if (!ufds.isSameSet(edges[e].u, edges[e].v)) {
+            ufds.linkSets(edges[e].u, edges[e].v);
+            link(e);
+            if (treeEdges == n - 1) break;
+        }
+    }
+}
+
+long long DynamicMST::key(int u, int v) const {
+    return (long long) std::min(u, v) * incident.size() + std::max(u, v);
+}
+
+int DynamicMST::other(int e, int v) const {
+    return edges[e].u == v ? edges[e].v : edges[e].u;
+}
+
+void DynamicMST::link(int e) {
+    edges[e].inTree = true;
+    treeAdj[edges[e].u].push_back(e);
+    treeAdj[edges[e].v].push_back(e);
+    weight += edges[e].weight;
+    treeEdges++;
+}
+
+void DynamicMST::cut(int e) {
+    edges[e].inTree = false;
+    for (int v : {edges[e].u, edges[e].v}) {
+        auto &adj = treeAdj[v];
+        *std::find(adj.begin(), adj.end(), e) = adj.back();
+        adj.pop_back();
+    }
+    weight -= edges[e].weight;
+    treeEdges--;
+}
+
+bool DynamicMST::update(int u, int v, double w) {
+    if (u < 0 || v < 0 || u >= (int) incident.size() || v >= (int) incident.size() || !index.count(key(u, v))) {
+        return false;
+    }
+    int e = index.at(key(u, v));
+    graph->setEdgeWeight(u, v, w);
+
+    double old = edges[e].weight;
+    edges[e].weight = w;
+    if (edges[e].inTree) {
+        weight += w - old;
+        if (w > old) reconnect(e);
+    } else if (w < old) {
+        replaceOnPath(e);
+    }
+    return true;
+}
+
+void DynamicMST::reconnect(int e) {
+    cut(e);
+
+    // both halves are searched one vertex at a time, so the work stops as soon as the smaller one is complete
+    std::vector<int> side[2] = {{edges[e].u}, {edges[e].v}};
+    unsigned int head[2] = {0, 0};
+    mark[edges[e].u] = 1;
+    mark[edges[e].v] = 2;
+    int small = -1;
+    while (small < 0) {
+        for (int s = 0; s < 2 && small < 0; s++) {
+            if (head[s] == side[s].size()) {
+                small = s;
+                break;
+            }
+            int x = side[s][head[s]++];
+            for (int f : treeAdj[x]) {
+                int y = other(f, x);
+                if (mark[y] == 0) {
+                    mark[y] = s + 1;
+                    side[s].push_back(y);
+                }
+            }
+        }
+    }
+
+    // the only tree edge across the cut was e, so every edge leaving the smaller half is outside the tree
+    int best = e;
+    for (int x : side[small]) {
+        for (int f : incident[x]) {
+            if (mark[other(f, x)] != small + 1 && edges[f].weight < edges[best].weight) {
+                best = f;
+            }
+        }
+    }
+    for (auto &s : side) {
+        for (int x : s) mark[x] = 0;
+    }
+
+    link(best);
+    if (best != e) swaps++;
+}
+
+void DynamicMST::replaceOnPath(int e) {
+    int u = edges[e].u, v = edges[e].v;
+    std::vector<int> visited = {u};
+    mark[u] = 1;
+    for (unsigned int head = 0; head < visited.size() && mark[v] == 0; head++) {
+        int x = visited[head];
+        for (int f : treeAdj[x]) {
+            int y = other(f, x);
+            if (mark[y] == 0) {
+                mark[y] = 1;
+                via[y] = f;
+                visited.push_back(y);
+            }
+        }
+    }
+
+    if (mark[v] == 0) {
+        // the ends are in different trees of the forest, which the edge joins
+        link(e);
+    } else {
+        int heaviest = -1;
+        for (int x = v; x != u; x = other(via[x], x)) {
+            if (heaviest < 0 || edges[via[x]].weight > edges[heaviest].weight) {
+                heaviest = via[x];
+            }
+        }
+        if (edges[heaviest].weight > edges[e].weight) {
+            cut(heaviest);
+            link(e);
+            swaps++;
+        }
+    }
+    for (int x : visited) {
+        mark[x] = 0;
+        via[x] = -1;
+    }
+}
+
+double DynamicMST::getWeight() const {
+    return weight;
+}
+
+int DynamicMST::getNumEdges() const {
+    return treeEdges;
+}
+
+int DynamicMST::getNumSwaps() const {
+    return swaps;
+}
+
+bool DynamicMST::inTree(int u, int v) const {
+    auto it = index.find(key(u, v));
+    return it != index.end() && edges[it->second].inTree;
+}
+
+RootedTree DynamicMST::getTree(int root) const {
+    int n = treeAdj.size();
+    std::vector<int> parents(n, -1), order;
+    std::vector<double> weights(n, 0);
+    if (root < 0 || root >= n) {
+        return RootedTree(-1, parents, weights);
+    }
+
+    std::vector<bool> visited(n, false);
+    order.push_back(root);
+    visited[root] = true;
+    for (unsigned int head = 0; head < order.size(); head++) {
+        int x = order[head];
+        for (int f : treeAdj[x]) {
+            int y = other(f, x);
+            if (!visited[y]) {
+                visited[y] = true;
+                parents[y] = x;
+                weights[y] = edges[f].weight;
+                order.push_back(y);
+            }
+        }
+    }
+
+    return RootedTree(root, std::move(parents), std::move(weights), std::move(order));
+}
@@ -0,0 +1,130 @@
+#ifndef ROUTING_ALGORITHM_DYNAMIC_MST_H
+#define ROUTING_ALGORITHM_DYNAMIC_MST_H
+
+/**
+* @file DynamicMST.h
+* @brief Contains the declaration of the DynamicMST class.
+* @author Luiz, Pedro e Raphael
+* @date 02/06/2023
+*/
+
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+
+#include "Graph.h"
+#include "RootedTree.h"
+#include "UFDS.h"
+
+/**
+ * @class DynamicMST
+ * @brief A minimum spanning tree (a forest, if the graph is not connected) of the edges of a graph, kept minimum while
+ * the weights of the edges change.
+ *
+ * Only two kinds of change can break the tree, and each one is fixed by a single swap:
+ * - a tree edge gets heavier: it is cut out, and the lightest edge across the cut between the two halves takes its place,
+ *   which may be the edge itself. Only the edges of the smaller half are scanned, found by searching both halves at once.
+ * - an edge outside the tree gets lighter: the heaviest edge on the tree path between its ends is swapped out for it,
+ *   if it is heavier.
+ * A tree edge that gets lighter or an edge outside the tree that gets heavier only changes the stored weight.
+ *
+ * The tree is rebuilt from scratch only once, by Kruskal's algorithm. Every update goes through Graph::setEdgeWeight,
+ * so the tours built from getTree() see the same weights as the tree.
+ */
+class DynamicMST {
+public:
+    /**
+    * @brief Constructs a DynamicMST object with the minimum spanning tree of the current edges of the graph.
+    * @param graph The graph, whose vertices are numbered 0 to |V| - 1.
+    * @complexity O(|E| log |E|)
+    */
+    explicit DynamicMST(Graph *graph);
+
+    /**
+    * @brief Changes the weight of the edge between two vertices, in the graph and in the tree.
+    *
+    * @param u The ID of one end of the edge.
+    * @param v The ID of the other end of the edge.
+    * @param w The new weight.
+    * @return False if there is no edge between the vertices.
+    * @complexity O(1) if the tree does not change, O(s + e) for a tree edge that gets heavier, where s is the number of
+    * vertices of the smaller half and e the number of edges incident to it, and O(c) for an edge outside the tree that gets
+    * lighter, where c is the number of vertices of its component.
+    */
+    bool update(int u, int v, double w);
+
+    /**
+    * @brief Returns the total weight of the tree.
+    * @complexity O(1)
+    */
+    double getWeight() const;
+
+    /**
+    * @brief Returns the number of edges of the tree.
+    * @complexity O(1)
+    */
+    int getNumEdges() const;
+
+    /**
+    * @brief Returns the number of swaps done by the updates so far.
+    * @complexity O(1)
+    */
+    int getNumSwaps() const;
+
+    /**
+    * @brief Checks if the edge between two vertices is in the tree.
+    * @complexity O(1) on average.
+    */
+    bool inTree(int u, int v) const;
+
+    /**
+    * @brief Returns the tree rooted at a vertex, which Graph::tourTriangApproxTsp, Graph::tourHeuristicApproxTsp and
+    * Graph::tourChristofidesApproxTsp take instead of running Prim's algorithm.
+    *
+    * The order of the tree is a breadth-first search from the root, so every vertex comes after its parent, like in the
+    * extraction order of Prim's algorithm.
+    *
+    * @param root The ID of the root.
+    * @return The tree, where the vertices outside the component of the root have no parent.
+    * @complexity O(|V| log |V|)
+    */
+    RootedTree getTree(int root) const;
+
+private:
+    struct MSTEdge {
+        int u, v;
+        double weight;
+        bool inTree = false;
+    };
+
+    Graph *graph;
+    std::vector<MSTEdge> edges;
+    std::unordered_map<long long, int> index;       // index of the edge between two vertices, by key(u, v)
+    std::vector<std::vector<int>> incident;         // indices of the edges of every vertex
+    std::vector<std::vector<int>> treeAdj;          // indices of the tree edges of every vertex
+    double weight = 0;
+    int treeEdges = 0;
+    int swaps = 0;
+
+    // scratch marks of the searches, reset after every use
+    std::vector<int> mark;
+    std::vector<int> via;
+
+    long long key(int u, int v) const;
+    int other(int e, int v) const;
+
+    void link(int e);
+    void cut(int e);
+
+    /**
+    * @brief Replaces a tree edge that got heavier by the lightest edge across the cut it leaves.
+    */
+    void reconnect(int e);
+
+    /**
+    * @brief Swaps an edge outside the tree that got lighter for the heaviest edge on the tree path between its ends.
+    */
+    void replaceOnPath(int e);
+};
+
+#endif
@@ -8,6 +8,460 @@ std::unordered_map<int, Vertex*> Graph::getVertexSet() const {
     return vertexSet;
 }
 
+double Graph::getDistance(const int &sourc, const int &dest) const {
+    if (distMatrix != nullptr) {
+        return distMatrix[sourc][dest];
+    }
+    double dist;
+    if (distanceCache != nullptr) {
+        if (distanceCache->get(sourc, dest, dist)) {
+            return dist;
+        }
+        dist = hierarchy != nullptr ? hierarchy->distance(sourc, dest) : aStar->distance(sourc, dest);
+        if (dist == INF) {
+            dist = findVertex(sourc)->getEdgeWeight(findVertex(dest));
+        }
+        distanceCache->put(sourc, dest, dist);
+        return dist;
+    }
+    if (hierarchy != nullptr) {
+        dist = hierarchy->distance(sourc, dest);
+        if (dist != INF) return dist;
+    }
+
+    return findVertex(sourc)->getEdgeWeight(findVertex(dest));
+}
+
+bool Graph::buildDistMatrix() {
+    int n = vertexSet.size();
+    for (auto v : vertexSet) {
+        if (v.first < 0 || v.first >= n) {
+            return false;
+        }
+    }
+    if (hierarchy != nullptr || distanceCache != nullptr) {
+        return buildRoadDistances(0, false);
+    }
+
+    deleteMatrix(distMatrix, n);
+    deleteMatrix(pathMatrix, n);
+    pathMatrix = nullptr;
+    roadMatrix = false;
+    distMatrix = new double *[n];
+    for (int i = 0; i < n; i++) {
+        distMatrix[i] = new double[n];
+        Vertex *v = findVertex(i);
+        for (int j = 0; j < n; j++) {
+            distMatrix[i][j] = (i == j) ? 0 : v->haversine_distance(findVertex(j));
+        }
+        for (auto e : v->getAdj()) {
+            distMatrix[i][e->getDest()->getId()] = e->getWeight();
+        }
+    }
+
+    return true;
+}
+
+bool Graph::hasDistMatrix() const {
+    return distMatrix != nullptr;
+}
+
+/*
+ * Relaxes the tile of the rows [i0, i0 + FW_BLOCK) and columns [j0, j0 + FW_BLOCK) through the vertices [k0, k0 + FW_BLOCK).
+ * The inner loop has no branches, so the compiler can turn it into vector min-plus operations.
+ */
+static void relaxTile(double **dist, int **next, int n, int i0, int j0, int k0) {
+    int iEnd = std::min(i0 + FW_BLOCK, n), jEnd = std::min(j0 + FW_BLOCK, n), kEnd = std::min(k0 + FW_BLOCK, n);
+    for (int k = k0; k < kEnd; k++) {
+        const double *dk = dist[k];
+        for (int i = i0; i < iEnd; i++) {
+            double dik = dist[i][k];
+            // the row of k cannot improve itself, and it is the only row that may alias dk
+            if (i == k || dik == INF) continue;
+            int nik = next[i][k];
+            double *di = dist[i];
+            int *ni = next[i];
+            for (int j = j0; j < jEnd; j++) {
+                double through = dik + dk[j];
+                bool shorter = through < di[j];
+                di[j] = shorter ? through : di[j];
+                ni[j] = shorter ? nik : ni[j];
+            }
+        }
+    }
+}
+
+bool Graph::buildShortestPaths(unsigned int threads) {
+    int n = vertexSet.size();
+    for (auto v : vertexSet) {
+        if (v.first < 0 || v.first >= n) {
+            return false;
+        }
+    }
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    deleteMatrix(distMatrix, n);
+    deleteMatrix(pathMatrix, n);
+    roadMatrix = true;
+    distMatrix = new double *[n];
+    pathMatrix = new int *[n];
+    for (int i = 0; i < n; i++) {
+        distMatrix[i] = new double[n];
+        pathMatrix[i] = new int[n];
+        std::fill(distMatrix[i], distMatrix[i] + n, INF);
+        std::fill(pathMatrix[i], pathMatrix[i] + n, -1);
+        distMatrix[i][i] = 0;
+        pathMatrix[i][i] = i;
+        for (auto e : findVertex(i)->getAdj()) {
+            int j = e->getDest()->getId();
+            if (j != i && e->getWeight() < distMatrix[i][j]) {
+                distMatrix[i][j] = e->getWeight();
+                pathMatrix[i][j] = j;
+            }
+        }
+    }
+
+    // runs relax(t) for every tile t in [0, tiles), with the tiles interleaved over the threads
+    auto parallelTiles = [threads](int tiles, const std::function<void(int)> &relax) {
+        std::vector<std::thread> pool;
+        for (unsigned int id = 1; id < threads && (int) id < tiles; id++) {
+            pool.emplace_back([&relax, id, tiles, threads]() {
+                for (int t = id; t < tiles; t += threads) relax(t);
+            });
+        }
+        for (int t = 0; t < tiles; t += threads) relax(t);
+        for (auto &thread : pool) {
+            thread.join();
+        }
+    };
+
+    int blocks = (n + FW_BLOCK - 1) / FW_BLOCK;
+    for (int kb = 0; kb < blocks; kb++) {
+        int k0 = kb * FW_BLOCK;
+        relaxTile(distMatrix, pathMatrix, n, k0, k0, k0);
+
+        // the tiles in the row and the column of the diagonal tile only read it besides themselves
+        parallelTiles(2 * blocks, [&](int t) {
+            int b = t / 2;
+            if (b == kb) return;
+            if (t % 2 == 0) relaxTile(distMatrix, pathMatrix, n, k0, b * FW_BLOCK, k0);
+            else relaxTile(distMatrix, pathMatrix, n, b * FW_BLOCK, k0, k0);
+        });
+
+        // every other tile only reads the tiles of the row and the column, so each thread takes whole rows of tiles
+        parallelTiles(blocks, [&](int ib) {
+            if (ib == kb) return;
+            for (int jb = 0; jb < blocks; jb++) {
+                if (jb != kb) relaxTile(distMatrix, pathMatrix, n, ib * FW_BLOCK, jb * FW_BLOCK, k0);
+            }
+        });
+    }
+
+    for (int i = 0; i < n; i++) {
+        Vertex *v = findVertex(i);
+        for (int j = 0; j < n; j++) {
+            if (pathMatrix[i][j] < 0) {
+                distMatrix[i][j] = v->haversine_distance(findVertex(j));
+            }
+        }
+    }
+
+    return true;
+}
+
+std::vector<int> Graph::getShortestPath(const int &sourc, const int &dest) const {
+    std::vector<int> path;
+    int n = vertexSet.size();
+    if (pathMatrix == nullptr || sourc < 0 || sourc >= n || dest < 0 || dest >= n || pathMatrix[sourc][dest] < 0) {
+        return path;
+    }
+
+    path.push_back(sourc);
+    for (int c = sourc; c != dest && (int) path.size() <= n; ) {
+        c = pathMatrix[c][dest];
+        path.push_back(c);
+    }
+    return path;
+}
+
+namespace {
+    /*
+     * The label of a vertex in one Dijkstra search or run of Prim, so every thread can have its own MutablePriorityQueue.
+     */
+    struct DijkstraLabel {
+        double dist = INF;
+        int queueIndex = 0;     // required by MutablePriorityQueue
+
+        bool operator<(const DijkstraLabel &label) const {
+            return dist < label.dist;
+        }
+    };
+}
+
+void Graph::dijkstraRows(const std::vector<int> &sources, const std::vector<int> &targets, double **dist, int **next, unsigned int threads) const {
+    int n = vertexSet.size();
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // compressed adjacency lists, so the threads read flat arrays and never touch the fields of the vertices
+    std::vector<int> offset(n + 1, 0);
+    for (int u = 0; u < n; u++) {
+        offset[u + 1] = offset[u] + findVertex(u)->getAdj().size();
+    }
+    std::vector<int> head(offset[n]);
+    std::vector<double> weight(offset[n]);
+    for (int u = 0; u < n; u++) {
+        int p = offset[u];
+        for (auto e : findVertex(u)->getAdj()) {
+            head[p] = e->getDest()->getId();
+            weight[p++] = e->getWeight();
+        }
+    }
+
+    std::vector<int> column(n, -1);
+    for (unsigned int c = 0; c < targets.size(); c++) {
+        column[targets[c]] = c;
+    }
+
+    std::atomic<int> nextSource(0);
+    auto worker = [&]() {
+        std::vector<DijkstraLabel> label(n);
+        std::vector<int> firstHop(n, -1), touched;
+        MutablePriorityQueue<DijkstraLabel> queue;
+
+        for (int r = nextSource++; r < (int) sources.size(); r = nextSource++) {
+            int s = sources[r];
+            label[s].dist = 0;
+            firstHop[s] = s;
+            touched.push_back(s);
+            queue.insert(&label[s]);
+
+            int left = targets.size();
+            while (!queue.empty() && left > 0) {
+                DijkstraLabel *settled = queue.extractMin();
+                int u = settled - label.data();
+                if (column[u] >= 0) {
+                    dist[r][column[u]] = settled->dist;
+                    if (next != nullptr) next[r][column[u]] = firstHop[u];
+                    left--;
+                }
+
+                for (int p = offset[u]; p < offset[u + 1]; p++) {
+                    int w = head[p];
+                    double d = settled->dist + weight[p];
+                    if (d < label[w].dist) {
+                        bool reached = label[w].dist != INF;
+                        label[w].dist = d;
+                        firstHop[w] = u == s ? w : firstHop[u];
+                        if (reached) {
+                            queue.decreaseKey(&label[w]);
+                        } else {
+                            touched.push_back(w);
+                            queue.insert(&label[w]);
+                        }
+                    }
+                }
+            }
+
+            if (left > 0) {
+                for (unsigned int c = 0; c < targets.size(); c++) {
+                    if (label[targets[c]].dist == INF) {
+                        dist[r][c] = findVertex(s)->haversine_distance(findVertex(targets[c]));
+                        if (next != nullptr) next[r][c] = -1;
+                    }
+                }
+            }
+
+            while (!queue.empty()) {
+                queue.extractMin();
+            }
+            for (int v : touched) {
+                label[v].dist = INF;
+                firstHop[v] = -1;
+            }
+            touched.clear();
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned int id = 1; id < threads; id++) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (auto &thread : pool) {
+        thread.join();
+    }
+}
+
+bool Graph::buildRoadDistances(unsigned int threads, bool paths) {
+    int n = vertexSet.size();
+    for (auto v : vertexSet) {
+        if (v.first < 0 || v.first >= n) {
+            return false;
+        }
+    }
+
+    deleteMatrix(distMatrix, n);
+    deleteMatrix(pathMatrix, n);
+    roadMatrix = true;
+    distMatrix = new double *[n];
+    pathMatrix = paths ? new int *[n] : nullptr;
+    for (int i = 0; i < n; i++) {
+        distMatrix[i] = new double[n];
+        if (paths) pathMatrix[i] = new int[n];
+    }
+
+    std::vector<int> all(n);
+    for (int i = 0; i < n; i++) {
+        all[i] = i;
+    }
+    dijkstraRows(all, all, distMatrix, pathMatrix, threads);
+
+    return true;
+}
+
+std::vector<std::vector<double>> Graph::getRoadDistances(const std::vector<int> &vertices, unsigned int threads) const {
+    int n = vertexSet.size();
+    for (auto v : vertexSet) {
+        if (v.first < 0 || v.first >= n) {
+            return {};
+        }
+    }
+
+    // the searches index their columns by ID and stop once every vertex of the subset is reached, so a repeated ID would never stop them
+    std::vector<bool> seen(n, false);
+    for (int v : vertices) {
+        if (v < 0 || v >= n || seen[v]) {
+            return {};
+        }
+        seen[v] = true;
+    }
+
+    std::vector<std::vector<double>> dist(vertices.size(), std::vector<double>(vertices.size()));
+    std::vector<double *> rows(vertices.size());
+    for (unsigned int r = 0; r < vertices.size(); r++) {
+        rows[r] = dist[r].data();
+    }
+    dijkstraRows(vertices, vertices, rows.data(), nullptr, threads);
+
+    return dist;
+}
+
+/*
+ * The number of directed edges of the graph.
+ */
+static long countEdges(const std::unordered_map<int, Vertex*> &vertexSet) {
+    long edges = 0;
+    for (auto &v : vertexSet) {
+        edges += v.second->getAdj().size();
+    }
+    return edges;
+}
+
+/*
+ * The finalizer of splitmix64, which spreads every bit of x over the whole result.
+ */
+static uint64_t mixBits(uint64_t x) {
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+/*
+ * A checksum of the (u, v, w) triples of the directed edges, which tells a saved hierarchy apart from the hierarchy of
+ * another graph, or of the same graph with other weights. The hashes of the edges are added, so the order of the edges
+ * in the file does not matter.
+ */
+static uint64_t edgesChecksum(const std::unordered_map<int, Vertex*> &vertexSet) {
+    uint64_t sum = 0;
+    for (auto &v : vertexSet) {
+        for (auto e : v.second->getAdj()) {
+            double w = e->getWeight();
+            uint64_t bits;
+            std::memcpy(&bits, &w, sizeof(bits));
+            sum += mixBits(mixBits(mixBits((uint64_t) v.first) ^ (uint64_t) e->getDest()->getId()) ^ bits);
+        }
+    }
+    return sum;
+}
+
+bool Graph::isSparse() const {
+    return countEdges(vertexSet) <= (long) HIERARCHY_MAX_DEGREE * (long) vertexSet.size();
+}
+
+bool Graph::buildHierarchy() {
+    int n = vertexSet.size();
+    std::vector<std::tuple<int, int, double>> edges;
+    for (auto &v : vertexSet) {
+        if (v.first < 0 || v.first >= n) {
+            return false;
+        }
+        for (auto e : v.second->getAdj()) {
+            edges.emplace_back(v.first, e->getDest()->getId(), e->getWeight());
+        }
+    }
+
+    hierarchy.reset(new ContractionHierarchy(n, edges));
+    hierarchyStale = false;
+    return true;
+}
+
+bool Graph::saveHierarchy(const std::string &filename) const {
+    return hierarchy != nullptr && hierarchy->save(filename, edgesChecksum(vertexSet));
+}
+
+bool Graph::loadHierarchy(const std::string &filename) {
+    std::unique_ptr<ContractionHierarchy> loaded(new ContractionHierarchy());
+    if (!loaded->load(filename, vertexSet.size(), edgesChecksum(vertexSet))) {
+        return false;
+    }
+
+    hierarchy = std::move(loaded);
+    hierarchyStale = false;
+    return true;
+}
+
+bool Graph::hasHierarchy() const {
+    return hierarchy != nullptr;
+}
+
+bool Graph::enableDistanceCache(std::size_t capacity) {
+    int n = vertexSet.size();
+    std::vector<Vertex *> vertices(n);
+    for (auto &v : vertexSet) {
+        if (v.first < 0 || v.first >= n) {
+            return false;
+        }
+        vertices[v.first] = v.second;
+    }
+
+    aStar.reset(new BidirectionalAStar(vertices));
+    distanceCache.reset(new DistanceCache(capacity));
+
+    // a matrix built before holds the edge weights, so it is rebuilt from the shortest paths when needed again
+    deleteMatrix(distMatrix, n);
+    deleteMatrix(pathMatrix, n);
+    distMatrix = nullptr;
+    pathMatrix = nullptr;
+    roadMatrix = false;
+    return true;
+}
+
+DistanceCache *Graph::getDistanceCache() const {
+    return distanceCache.get();
+}
+
+double Graph::getTourLength(const Tour &tour) const {
+    double length = 0;
+    for (int c = 0; c < tour.size(); c++) {
+        length += getDistance(c, tour.next(c));
+    }
+    return length;
+}
+
 /*
  * Auxiliary function to find a vertex with a given content.
  */
@@ -73,289 +527,709 @@ bool Graph::addBidirectionalEdge(const int &sourc, const int &dest, double w) co
     return true;
 }
 
-std::list<Vertex *> Graph::prim(const int & source) {
-    std::list<Vertex *> mst;
-    if (vertexSet.empty()) {
-        return mst;
+bool Graph::setEdgeWeight(const int &sourc, const int &dest, double w) {
+    Vertex *v1 = findVertex(sourc), *v2 = findVertex(dest);
+    if (v1 == nullptr || v2 == nullptr) {
+        return false;
     }
+    Edge *e1 = v1->getEdge(v2), *e2 = v2->getEdge(v1);
+    if (e1 == nullptr && e2 == nullptr) {
+        return false;
+    }
+    if (e1 != nullptr) e1->setWeight(w);
+    if (e2 != nullptr) e2->setWeight(w);
 
-    for(auto v : vertexSet) {
-        v.second->setDist(INF);
-        v.second->setPath(nullptr);
-        v.second->setVisited(false);
-        v.second->setMstDegree(1);
+    // a matrix of edge weights only needs its two entries
+    if (!roadMatrix && distMatrix != nullptr) {
+        if (e1 != nullptr) distMatrix[sourc][dest] = w;
+        if (e2 != nullptr) distMatrix[dest][sourc] = w;
+    }
+    if (!roadMatrix && hierarchy == nullptr && distanceCache == nullptr) {
+        return true;
     }
 
-    Vertex *s = findVertex(source);
-    s->setDist(0);
-    s->setMstDegree(0);
+    // the road matrix and the hierarchy keep the old distances and take long to build again, so the shortest path
+    // distances are computed on demand by the bidirectional A* and the cache, until the hierarchy is rebuilt
+    hierarchyStale = hierarchyStale || hierarchy != nullptr;
+    hierarchy.reset();
+    if (aStar == nullptr || distanceCache == nullptr) {
+        // the first update since the A* was dropped builds it from the new weights
+        enableDistanceCache(distanceCache != nullptr ? distanceCache->getCapacity() : DISTANCE_CACHE_CAPACITY);
+        return true;
+    }
 
-    MutablePriorityQueue<Vertex> q;
-    q.insert(s);
+    // the later ones only patch the A* and forget the cached distances
+    if (e1 != nullptr) aStar->setWeight(sourc, dest, w);
+    if (e2 != nullptr) aStar->setWeight(dest, sourc, w);
+    distanceCache->clear();
+    if (roadMatrix) {
+        int n = vertexSet.size();
+        deleteMatrix(distMatrix, n);
+        deleteMatrix(pathMatrix, n);
+        distMatrix = nullptr;
+        pathMatrix = nullptr;
+        roadMatrix = false;
+    }
+    return true;
+}
+
+bool Graph::isHierarchyStale() const {
+    return hierarchyStale;
+}
+
+RootedTree Graph::prim(const int & source) const {
+    int n = vertexSet.size();
+    std::vector<int> parents(n, -1), order;
+    std::vector<double> weight(n, 0);
+    const Vertex *s = findVertex(source);
+    if (s == nullptr) {
+        return RootedTree(-1, parents, weight);
+    }
+
+    // the keys and the visited marks are local, so several threads can build trees of the same graph at once
+    std::vector<DijkstraLabel> label(n);
+    std::vector<const Edge *> via(n, nullptr);
+    std::vector<bool> visited(n, false);
+    label[source].dist = 0;
+
+    MutablePriorityQueue<DijkstraLabel> q;
+    q.insert(&label[source]);
 
     while(!q.empty()) {
-        auto v = q.extractMin();
-        mst.push_back(v);
-        if (v->getPath() != nullptr) {
-            v->getPath()->getOrig()->increaseMstDegree();
-            v->getPath()->setSelected(true);
-            v->getPath()->getReverse()->setSelected(true);
-        }
-        v->setVisited(true);
-        std::vector<Edge *> adj = v->getAdj();
+        int v = q.extractMin() - label.data();
+        order.push_back(v);
+        if (via[v] != nullptr) {
+            parents[v] = via[v]->getOrig()->getId();
+            weight[v] = via[v]->getWeight();
+        }
+        visited[v] = true;
+        std::vector<Edge *> adj = findVertex(v)->getAdj();
         std::sort(adj.begin(), adj.end(), [](const Edge* a, const Edge* b){
             return a->getWeight() < b->getWeight();
         });
         for (auto &e : adj) {
-            Vertex *w = e->getDest();
-            if (!w->isVisited()) {
-                double oldDist = w->getDist();
+            int w = e->getDest()->getId();
+            if (!visited[w]) {
+                double oldDist = label[w].dist;
                 if (e->getWeight() < oldDist) {
-                    w->setDist(e->getWeight());
-                    w->setPath(e);
+                    label[w].dist = e->getWeight();
+                    via[w] = e;
 
                     if (oldDist == INF) {
-                        q.insert(w);
+                        q.insert(&label[w]);
                     }
                     else {
-                        q.decreaseKey(w);
+                        q.decreaseKey(&label[w]);
                     }
                 }
             }
         }
     }
 
-    return mst;
+    return RootedTree(source, std::move(parents), std::move(weight), std::move(order));
 }
 
-std::vector<Vertex *> Graph::tourTriangApproxTsp(const int &source) {
-    std::vector<Vertex *> tour;
-
-    this->prim(source);
+Tour Graph::tourTriangApproxTsp(const int &source) const {
+    return tourTriangApproxTsp(prim(source));
+}
 
-    auto s = findVertex(source);
-    if (s == nullptr) {
-        return tour;
+Tour Graph::tourTriangApproxTsp(const RootedTree &mst) const {
+    // a forest leaves the other components out of the tour
+    if (mst.getPreorder().size() != vertexSet.size()) {
+        return Tour();
     }
 
-    for (auto v : vertexSet) {
-        v.second->setVisited(false);
+    // the preorder of the MST visits the children of every vertex by increasing edge weight
+    return Tour(mst.getPreorder());
+}
+
+Tour Graph::tourHeuristicApproxTsp(const int &source) const {
+    return tourHeuristicApproxTsp(prim(source));
+}
+
+Tour Graph::tourHeuristicApproxTsp(const RootedTree &mst) const {
+    if (mst.getPreorder().empty() || mst.getPreorder().size() != vertexSet.size()) {
+        return Tour();
     }
 
-    dfsVisit(s, tour);
+    RootedTree walk = heuristicVisit(mst);
+    std::vector<int> order;
+    dfsVisitCycles(findVertex(mst.getRoot()), walk, order);
 
-    return tour;
+    return Tour(order);
 }
 
-void Graph::dfsVisit(Vertex *v, std::vector<Vertex *> &tour) const {
-    v->setVisited(true);
-    tour.push_back(v);
-    auto adj = v->getAdj();
-    std::sort(adj.begin(), adj.end(), [](const Edge* a, const Edge* b){
-        return a->getWeight() < b->getWeight();
-    });
-    for (auto &e : adj) {
-        auto w = e->getDest();
-        if (!w->isVisited() && w->getPath()->getOrig()->getId() == v->getId()) {
-            dfsVisit(w, tour);
+RootedTree Graph::heuristicVisit(const RootedTree &mst) const {
+    std::vector<int> parent = mst.getParents();
+    std::vector<double> weight = mst.getWeights();
+    std::vector<bool> processing(parent.size(), false);
+
+    for (int v : mst.getOrder()) {
+        if (v == mst.getRoot()) {
+            continue;
+        }
+
+        if (!processing[parent[v]]) {
+            processing[parent[v]] = true;
+        } else {
+            double min = INF;
+            int closest = -1;
+            for (auto e : findVertex(v)->getAdj()) {
+                int w = e->getDest()->getId();
+                if (!processing[w] && e->getWeight() < min) {
+                    min = e->getWeight();
+                    closest = w;
+                }
+            }
+
+            if (closest >= 0) {
+                parent[v] = closest;
+                weight[v] = min;
+                processing[closest] = true;
+            }
         }
     }
+
+    return RootedTree(mst.getRoot(), std::move(parent), std::move(weight));
+}
+
+Tour Graph::tourChristofidesApproxTsp(const int &source) {
+    double matchingCost, matchingTime;
+    return tourChristofidesApproxTsp(source, exactMatching, matchingCost, matchingTime);
 }
 
-std::vector<Vertex *> Graph::tourHeuristicApproxTsp(const int &source) {
-    std::list<Vertex *> mst = prim(source);
+Tour Graph::tourChristofidesApproxTsp(const int &source, MatchingMethod method, double &matchingCost, double &matchingTime) {
+    return tourChristofidesApproxTsp(prim(source), method, matchingCost, matchingTime);
+}
 
-    for (auto v : vertexSet) {
-        v.second->setVisited(false);
-        v.second->setProcessing(false);
+Tour Graph::tourChristofidesApproxTsp(const RootedTree &mst, MatchingMethod method, double &matchingCost, double &matchingTime) {
+    matchingCost = 0;
+    matchingTime = 0;
+    if (mst.getPreorder().size() != vertexSet.size()) {
+        return Tour();
     }
 
-    Vertex *initial = mst.front();
-    initial->setVisited(true);
-    mst.pop_front();
+    vector<int> oddVertices;
 
-    heuristicVisit(mst);
-    std::vector<Vertex *> tour;
+    for (int v : mst.getOrder()) {
+        if (mst.getDegree(v) % 2 != 0) {
+            oddVertices.push_back(v);
+        }
+    }
+
+    PerfectMatching matching(this, oddVertices);
+    std::vector<int> mate(vertexSet.size(), -1);
+    for (auto &p : matching.solve(method)) {
+        mate[p.first] = p.second;
+        mate[p.second] = p.first;
+    }
+    matchingCost = matching.getCost();
+    matchingTime = matching.getTime();
 
-    dfsVisitCycles(initial, tour, 1);
+    std::vector<int> order;
+    christofidesVisit(mst, mate, order);
 
-    return tour;
+    return Tour(order);
 }
 
-void Graph::heuristicVisit(std::list<Vertex *> &mst) {
-    Vertex *v = mst.front();
-    mst.pop_front();
+Tour Graph::tourGreedyEdgeTsp() {
+    int n = vertexSet.size();
+    if (n == 0) {
+        return Tour();
+    }
 
-    if (!v->getPath()->getOrig()->isProcessing()) {
-        v->getPath()->getOrig()->setProcessing(true);
-    } else {
-        double min = INF;
-        Edge *tmp = nullptr;
-        for (auto e : v->getAdj()) {
-            if (!e->getDest()->isProcessing() && e->getWeight() < min) {
-                min = e->getWeight();
-                tmp = e->getReverse();
+    std::vector<Edge *> edges;
+    for (auto v : vertexSet) {
+        for (auto e : v.second->getAdj()) {
+            if (e->getOrig()->getId() < e->getDest()->getId()) {
+                edges.push_back(e);
             }
         }
+    }
+    std::sort(edges.begin(), edges.end(), [](const Edge* a, const Edge* b){
+        return a->getWeight() < b->getWeight();
+    });
 
-        if (tmp != nullptr) {
-            v->setPath(tmp);
-            tmp->getOrig()->setProcessing(true);
+    UFDS ufds(n);
+    std::vector<std::vector<int>> links(n);
+    int accepted = 0;
+    for (auto e : edges) {
+        int u = e->getOrig()->getId(), v = e->getDest()->getId();
+        if (links[u].size() < 2 && links[v].size() < 2 && !ufds.isSameSet(u, v)) {
+            links[u].push_back(v);
+            links[v].push_back(u);
+            ufds.linkSets(u, v);
+            if (++accepted == n - 1) {
+                break;
+            }
         }
     }
 
-    if (mst.empty()) {
-        return ;
+    std::vector<int> ends;
+    for (int c = 0; c < n; c++) {
+        if (links[c].size() < 2) {
+            ends.push_back(c);
+        }
     }
 
-    heuristicVisit(mst);
-}
-
-std::vector<Vertex *> Graph::tourChristofidesApproxTsp(const int &source) {
-    std::list<Vertex *> mst = prim(source);
-    vector<Vertex *> oddVertices;
+    std::vector<bool> visited(n, false);
+    std::vector<int> order;
+    int c = ends.front();
+    while (true) {
+        int prev = -1;
+        while (true) {
+            order.push_back(c);
+            visited[c] = true;
+            int next = -1;
+            for (int w : links[c]) {
+                if (w != prev && !visited[w]) next = w;
+            }
+            if (next < 0) break;
+            prev = c;
+            c = next;
+        }
 
-    for (auto &v : mst) {
-        if (v->getMstDegree() % 2 != 0) {
-            oddVertices.push_back(v);
+        if ((int) order.size() == n) {
+            break;
         }
-    }
 
-    for (auto v : vertexSet) {
-        v.second->setVisited(false);
+        double min = INF;
+        int closest = -1;
+        for (int e : ends) {
+            if (!visited[e] && getDistance(c, e) < min) {
+                min = getDistance(c, e);
+                closest = e;
+            }
+        }
+        c = closest;
     }
 
-    for (int i = 0; i < oddVertices.size(); ++i) {
-        if (!oddVertices[i]->isVisited()) {
-            double minWeight = INF;
-            int u = -1, v = -1;
+    return Tour(order);
+}
 
-            for (int j = i + 1; j < oddVertices.size(); j++) {
-                double weight = oddVertices[i]->getEdgeWeight(oddVertices[j]);
-                if (!oddVertices[j]->isVisited() && weight < minWeight) {
-                    minWeight = weight;
-                    u = i;
-                    v = j;
+/**
+* @brief Computes the index of the cell (x, y) along the Hilbert curve that fills the 2^32 x 2^32 grid.
+*
+* The curve is followed as a state machine with four orientations (Hacker's Delight, figure 16-8). The transitions for
+* four bits of each coordinate at a time are tabulated once, so a key takes 8 table lookups and no branches.
+*/
+static uint64_t hilbertIndex(uint32_t x, uint32_t y) {
+    // table[state][x bits << 4 | y bits] holds the 8 bits of the index in the low byte and the next state above it
+    static const std::vector<std::vector<uint16_t>> table = []() {
+        std::vector<std::vector<uint16_t>> t(4, std::vector<uint16_t>(256));
+        for (uint32_t first = 0; first < 4; first++) {
+            for (uint32_t bits = 0; bits < 256; bits++) {
+                uint32_t state = first, digits = 0;
+                for (int i = 3; i >= 0; i--) {
+                    uint32_t row = 4 * state | 2 * ((bits >> (4 + i)) & 1) | ((bits >> i) & 1);
+                    digits = (digits << 2) | ((0x361E9CB4u >> (2 * row)) & 3);
+                    state = (0x8FE65831u >> (2 * row)) & 3;
                 }
+                t[first][bits] = digits | (state << 8);
             }
+        }
+        return t;
+    }();
+
+    uint64_t d = 0;
+    uint32_t state = 0;
+    for (int i = 28; i >= 0; i -= 4) {
+        uint16_t entry = table[state][((x >> i) & 15) << 4 | ((y >> i) & 15)];
+        d = (d << 8) | (entry & 255);
+        state = entry >> 8;
+    }
+    return d;
+}
+
+/**
+* @brief Sorts the ids by their keys with a least significant digit radix sort on 16-bit digits.
+*/
+static void radixSort(std::vector<uint64_t> &keys, std::vector<int> &ids) {
+    const int bits = 16, buckets = 1 << bits;
+    std::vector<uint64_t> sortedKeys(keys.size());
+    std::vector<int> sortedIds(ids.size());
+    std::vector<size_t> count(buckets);
+
+    for (int shift = 0; shift < 64; shift += bits) {
+        std::fill(count.begin(), count.end(), 0);
+        for (uint64_t key : keys) {
+            count[(key >> shift) & (buckets - 1)]++;
+        }
+        if (count[(keys.front() >> shift) & (buckets - 1)] == keys.size()) {
+            continue;
+        }
 
-            Edge *e = oddVertices[u]->getEdge(oddVertices[v]);
-            e->setPerfectMatch(true);
-            e->getReverse()->setPerfectMatch(true);
-            oddVertices[u]->setVisited(true);
-            oddVertices[v]->setVisited(true);
+        size_t total = 0;
+        for (auto &c : count) {
+            size_t tmp = c;
+            c = total;
+            total += tmp;
+        }
+        for (size_t i = 0; i < keys.size(); i++) {
+            size_t to = count[(keys[i] >> shift) & (buckets - 1)]++;
+            sortedKeys[to] = keys[i];
+            sortedIds[to] = ids[i];
         }
+        keys.swap(sortedKeys);
+        ids.swap(sortedIds);
     }
+}
 
-    for (auto v : vertexSet) {
-        v.second->setVisited(false);
+Tour Graph::tourHilbertTsp() const {
+    if (vertexSet.empty()) {
+        return Tour();
     }
 
-    std::vector<Vertex *> eulerian;
-    christofidesVisit(mst.front(), eulerian);
+    std::vector<int> ids;
+    std::vector<double> xs, ys;
+    ids.reserve(vertexSet.size());
+    xs.reserve(vertexSet.size());
+    ys.reserve(vertexSet.size());
 
-    std::reverse(eulerian.begin(), eulerian.end());
-    for (auto &v : eulerian) {
-        v->setVisited(false);
+    double meanLat = 0;
+    for (auto v : vertexSet) {
+        ids.push_back(v.first);
+        xs.push_back(v.second->getLong());
+        ys.push_back(v.second->getLat());
+        meanLat += ys.back();
     }
+    double scale = std::cos(meanLat / ids.size() * M_PI / 180.0);
 
-    std::vector<Vertex *> tour;
-    for (auto &v : eulerian) {
-        if (!v->isVisited()) {
-            tour.push_back(v);
-            v->setVisited(true);
-        }
+    double minX = INF, minY = INF, maxX = -INF, maxY = -INF;
+    for (size_t i = 0; i < ids.size(); i++) {
+        xs[i] *= scale;
+        minX = std::min(minX, xs[i]);
+        maxX = std::max(maxX, xs[i]);
+        minY = std::min(minY, ys[i]);
+        maxY = std::max(maxY, ys[i]);
+    }
+
+    // the same scale on both axes keeps the curve from being stretched, and staying below 2^32 - 1 absorbs rounding errors
+    double range = std::max(maxX - minX, maxY - minY);
+    double cells = range > 0 ? 4294967040.0 / range : 0;
+
+    std::vector<uint64_t> keys(ids.size());
+    for (size_t i = 0; i < ids.size(); i++) {
+        keys[i] = hilbertIndex((uint32_t) ((xs[i] - minX) * cells), (uint32_t) ((ys[i] - minY) * cells));
     }
+    radixSort(keys, ids);
 
-    return tour;
+    return Tour(ids);
 }
 
-void Graph::christofidesVisit(Vertex *v, std::vector<Vertex *> &eulerian) const {
-    std::stack<Vertex *> stack;
-    Vertex *vertex = v;
-    std::vector<Edge *> adj;
+Tour Graph::tourInsertionTsp(const int &source, InsertionRule rule) {
+    int n = vertexSet.size();
+    if (findVertex(source) == nullptr) {
+        return Tour();
+    }
 
-    for (auto &e: vertex->getAdj()) {
-        if (e->isSelected() || e->isPerfectMatch()) {
-            adj.push_back(e);
-        }
+    std::vector<int> next(n, source), prev(n, source), bestPrev(n, source);
+    std::vector<Vertex *> remaining;
+    MutablePriorityQueue<Vertex> q;
+
+    // the tour starts with the source alone, as a loop of length 0
+    auto insertionCost = [this, &next](int a, int c) {
+        return getDistance(a, c) + getDistance(c, next[a]) - getDistance(a, next[a]);
+    };
+    auto cheapestEdge = [&](int c) {
+        double min = INF;
+        int a = source;
+        do {
+            if (insertionCost(a, c) < min) {
+                min = insertionCost(a, c);
+                bestPrev[c] = a;
+            }
+            a = next[a];
+        } while (a != source);
+        return min;
+    };
+
+    for (auto v : vertexSet) {
+        if (v.first == source) continue;
+        remaining.push_back(v.second);
+        double d = getDistance(source, v.first);
+        v.second->setDist(rule == cheapestInsertion ? 2 * d : rule == farthestInsertion ? -d : d);
+        q.insert(v.second);
     }
 
-    std::sort(adj.begin(), adj.end(), [](const Edge* a, const Edge* b){
-        return a->getWeight() < b->getWeight();
-    });
-    while (!stack.empty() || adj.size() > 0) {
-        if (adj.empty()) {
-            eulerian.push_back(vertex);
-            vertex = stack.top();
-            stack.pop();
-        } else {
-            stack.push(vertex);
-            Edge *neighbor = nullptr;
-            for (auto &e : adj) {
-                if (e->isPerfectMatch()) {
-                    neighbor = e;
-                    neighbor->setPerfectMatch(false);
-                    neighbor->getReverse()->setPerfectMatch(false);
+    while (!q.empty()) {
+        Vertex *v = q.extractMin();
+        int c = v->getId();
+        if (rule != cheapestInsertion) {
+            cheapestEdge(c);
+        }
+        int a = bestPrev[c];
+        int b = next[a];
+        next[a] = c;
+        prev[c] = a;
+        next[c] = b;
+        prev[b] = c;
+        remaining.erase(std::find(remaining.begin(), remaining.end(), v));
+
+        for (Vertex *w : remaining) {
+            int u = w->getId();
+            double key = w->getDist();
+
+            if (rule == nearestInsertion) {
+                if (getDistance(u, c) < key) {
+                    w->setDist(getDistance(u, c));
+                    q.decreaseKey(w);
+                }
+            } else if (rule == farthestInsertion) {
+                if (-getDistance(u, c) > key) {
+                    w->setDist(-getDistance(u, c));
+                    q.increaseKey(w);
+                }
+            } else if (bestPrev[u] == a) {
+                // the edge (a, b) where u was best inserted is gone, so its cost can only be recomputed from scratch
+                w->setDist(cheapestEdge(u));
+                if (w->getDist() > key) q.increaseKey(w);
+                else q.decreaseKey(w);
+            } else {
+                for (int x : {a, c}) {
+                    if (insertionCost(x, u) < w->getDist()) {
+                        w->setDist(insertionCost(x, u));
+                        bestPrev[u] = x;
+                    }
                 }
+                q.decreaseKey(w);
             }
+        }
+    }
 
-            if (neighbor == nullptr) {
-                neighbor = adj.front();
-                neighbor->setSelected(false);
-                neighbor->getReverse()->setSelected(false);
+    std::vector<int> order;
+    int c = source;
+    do {
+        order.push_back(c);
+        c = next[c];
+    } while (c != source);
+
+    return Tour(order);
+}
+
+Tour Graph::tourSavingsTsp(const int &depot) {
+    int n = vertexSet.size();
+    Vertex *d = findVertex(depot);
+    if (d == nullptr) {
+        return Tour();
+    }
+
+    // distances to the depot in the same metric as the stitching below, which may be hierarchy, A* or road matrix distances
+    std::vector<double> toDepot(n, 0);
+    for (auto v : vertexSet) {
+        toDepot[v.first] = getDistance(depot, v.first);
+    }
+
+    // the savings of the SAVINGS_CANDIDATES nearest neighbours of each vertex, sorted by decreasing saving
+    std::vector<std::vector<std::pair<double, int>>> candidates(n);
+    std::vector<std::pair<double, int>> savings;
+    for (auto v : vertexSet) {
+        int i = v.first;
+        if (i == depot) continue;
+        savings.clear();
+        for (auto e : v.second->getAdj()) {
+            int j = e->getDest()->getId();
+            if (j != depot) {
+                savings.emplace_back(e->getWeight(), j);
             }
+        }
+        auto middle = savings.begin() + std::min((int) savings.size(), SAVINGS_CANDIDATES);
+        std::partial_sort(savings.begin(), middle, savings.end());
+        for (auto it = savings.begin(); it != middle; it++) {
+            it->first = toDepot[i] + toDepot[it->second] - getDistance(i, it->second);
+        }
+        std::sort(savings.begin(), middle, std::greater<std::pair<double, int>>());
+        candidates[i].assign(savings.begin(), middle);
+    }
 
-            vertex = neighbor->getDest();
+    // the queue only holds the next unread saving of each vertex
+    std::vector<int> cursor(n, 0);
+    std::priority_queue<std::pair<double, int>> q;
+    for (int i = 0; i < n; i++) {
+        if (!candidates[i].empty()) {
+            q.emplace(candidates[i][0].first, i);
         }
+    }
+
+    UFDS ufds(n);
+    std::vector<std::vector<int>> links(n);
+    int accepted = 0;
+    while (!q.empty() && accepted < n - 2) {
+        int i = q.top().second;
+        q.pop();
+        int j = candidates[i][cursor[i]].second;
+        if (++cursor[i] < (int) candidates[i].size()) {
+            q.emplace(candidates[i][cursor[i]].first, i);
+        }
+
+        if (links[i].size() < 2 && links[j].size() < 2 && !ufds.isSameSet(i, j)) {
+            links[i].push_back(j);
+            links[j].push_back(i);
+            ufds.linkSets(i, j);
+            accepted++;
+        }
+    }
 
-        adj.clear();
-        for (auto &e: vertex->getAdj()) {
-            if (e->isSelected() || e->isPerfectMatch()) {
-                adj.push_back(e);
+    std::vector<int> ends;
+    for (int c = 0; c < n; c++) {
+        if (c != depot && links[c].size() < 2) {
+            ends.push_back(c);
+        }
+    }
+
+    std::vector<bool> visited(n, false);
+    std::vector<int> order = {depot};
+    visited[depot] = true;
+    int c = depot;
+    while ((int) order.size() < n) {
+        double min = INF;
+        int closest = -1;
+        for (int e : ends) {
+            if (!visited[e] && getDistance(c, e) < min) {
+                min = getDistance(c, e);
+                closest = e;
             }
         }
 
-        std::sort(adj.begin(), adj.end(), [](const Edge* a, const Edge* b){
-            return a->getWeight() < b->getWeight();
-        });
+        c = closest;
+        int prev = -1;
+        while (true) {
+            order.push_back(c);
+            visited[c] = true;
+            int next = -1;
+            for (int w : links[c]) {
+                if (w != prev && !visited[w]) next = w;
+            }
+            if (next < 0) break;
+            prev = c;
+            c = next;
+        }
     }
 
-    eulerian.push_back(vertex);
+    return Tour(order);
 }
 
-void Graph::dfsVisitCycles(Vertex *v, std::vector<Vertex *> &tour, int numVert) const {
-    v->setVisited(true);
-    tour.push_back(v);
-    auto adj = v->getAdj();
-    std::sort(adj.begin(), adj.end(), [](const Edge* a, const Edge* b){
-        return a->getWeight() < b->getWeight();
-    });
-    bool has_cycles = true;
-    for (auto &e : adj) {
-        auto w = e->getDest();
-        if (!w->isVisited() && w->getPath()->getOrig()->getId() == v->getId()) {
-            dfsVisitCycles(w, tour, numVert + 1);
-            has_cycles = false;
+void Graph::christofidesVisit(const RootedTree &mst, const std::vector<int> &mate, std::vector<int> &order) const {
+    int n = vertexSet.size();
+    if (mst.getRoot() < 0) {
+        return;
+    }
+
+    // the multigraph of the matched pairs and the MST edges, with the pairs first in the incidence list of every vertex
+    std::vector<int> ends;
+    for (int v = 0; v < n; v++) {
+        if (v < mate[v]) {
+            ends.push_back(v);
+            ends.push_back(mate[v]);
+        }
+    }
+    for (int v = 0; v < n; v++) {
+        if (mst.getParent(v) >= 0) {
+            ends.push_back(mst.getParent(v));
+            ends.push_back(v);
         }
     }
 
-    if (numVert != vertexSet.size() && has_cycles) {
-        double min = INF;
-        Vertex *newVertex;
-        for (auto &e : v->getAdj()) {
-            auto w = e->getDest();
-            if (!w->isVisited() && e->getWeight() < min) {
-                min = e->getWeight();
+    int m = ends.size() / 2;
+    std::vector<int> offset(n + 1, 0), incident(2 * m);
+    for (int end : ends) {
+        offset[end + 1]++;
+    }
+    for (int v = 0; v < n; v++) {
+        offset[v + 1] += offset[v];
+    }
+    std::vector<int> cursor(offset.begin(), offset.end() - 1);
+    for (int i = 0; i < 2 * m; i++) {
+        incident[cursor[ends[i]]++] = i / 2;
+    }
+
+    // Hierholzer's algorithm: a vertex leaves the stack once all its edges are used, which happens in the order of an
+    // Euler circuit, so the circuit is shortcut to its first occurrences as the vertices leave
+    std::copy(offset.begin(), offset.end() - 1, cursor.begin());
+    std::vector<bool> used(m, false), visited(n, false);
+    std::vector<int> stack = {mst.getRoot()};
+    while (!stack.empty()) {
+        int v = stack.back();
+        while (cursor[v] < offset[v + 1] && used[incident[cursor[v]]]) {
+            cursor[v]++;
+        }
+
+        if (cursor[v] == offset[v + 1]) {
+            stack.pop_back();
+            if (!visited[v]) {
+                visited[v] = true;
+                order.push_back(v);
+            }
+        } else {
+            int e = incident[cursor[v]++];
+            used[e] = true;
+            stack.push_back(ends[2 * e] == v ? ends[2 * e + 1] : ends[2 * e]);
+        }
+    }
+}
+
+void Graph::dfsVisitCycles(Vertex *v, const RootedTree &tree, std::vector<int> &order) const {
+    int n = vertexSet.size();
+    std::vector<bool> visited(n, false);
+    std::unique_ptr<KdTree> unvisited;
+    double scale = 1;
+    while (true) {
+        visited[v->getId()] = true;
+        order.push_back(v->getId());
+        if ((int) order.size() == n) {
+            break;
+        }
+        if (unvisited != nullptr) {
+            unvisited->remove(v->getId());
+        }
+
+        // the walk goes down to the first unvisited child, and from a leaf jumps to the closest unvisited vertex
+        Vertex *newVertex = nullptr;
+        for (int i = 0; i < tree.getNumChildren(v->getId()); i++) {
+            Vertex *w = findVertex(tree.getChild(v->getId(), i));
+            if (!visited[w->getId()]) {
                 newVertex = w;
+                break;
+            }
+        }
+
+        double min = INF;
+        if (newVertex == nullptr) {
+            for (auto &e : v->getAdj()) {
+                auto w = e->getDest();
+                if (!visited[w->getId()] && e->getWeight() < min) {
+                    min = e->getWeight();
+                    newVertex = w;
+                }
+            }
+        }
+
+        // on graphs that are not complete every neighbour may already be visited, and the closest unvisited vertex
+        // is found by its coordinates in a k-d tree of the unvisited vertices, built the first time it is needed
+        if (newVertex == nullptr) {
+            if (unvisited == nullptr) {
+                double meanLat = 0;
+                for (auto &w : vertexSet) {
+                    meanLat += w.second->getLat();
+                }
+                scale = std::cos(meanLat / n * M_PI / 180.0);
+
+                std::vector<std::pair<double, double>> points(n);
+                for (auto &w : vertexSet) {
+                    points[w.first] = {w.second->getLong() * scale, w.second->getLat()};
+                }
+                unvisited.reset(new KdTree(points));
+                for (int w : order) {
+                    unvisited->remove(w);
+                }
             }
+            newVertex = findVertex(unvisited->nearest(v->getLong() * scale, v->getLat()));
         }
 
-        dfsVisitCycles(newVertex, tour, numVert + 1);
+        v = newVertex;
     }
 }
 
-
 void deleteMatrix(int **m, int n) {
     if (m != nullptr) {
         for (int i = 0; i < n; i++)
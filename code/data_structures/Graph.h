@@ -16,12 +16,40 @@
 #include <algorithm>
 #include <unordered_map>
 #include <cmath>
+#include <cstdint>
+#include <memory>
+#include <queue>
+#include <thread>
+#include <functional>
+#include <atomic>
+#include <cstring>
 
 #include "../data_structures/MutablePriorityQueue.h"
 #include "VertexEdge.h"
+#include "Tour.h"
+#include "UFDS.h"
+#include "PerfectMatching.h"
+#include "KdTree.h"
+#include "RootedTree.h"
+#include "ContractionHierarchy.h"
+#include "BidirectionalAStar.h"
+#include "DistanceCache.h"
 
 using namespace std;
 
+#define SAVINGS_CANDIDATES 16
+#define FW_BLOCK 64
+#define HIERARCHY_MAX_DEGREE 8
+
+/**
+ * @brief The rule used by the insertion heuristics to choose the next vertex to insert in the tour.
+ */
+enum InsertionRule {
+    cheapestInsertion,  // the vertex whose insertion increases the tour the least
+    farthestInsertion,  // the vertex farthest from the tour
+    nearestInsertion    // the vertex closest to the tour
+};
+
 /**
  * @class Graph
  * @brief Represents the graph that´s going to be used for the routing algorithm program.
@@ -97,6 +125,32 @@ public:
     */
     bool addBidirectionalEdge(const int &sourc, const int &dest, double w) const;
 
+    /**
+    * @brief Changes the weight of the edge between two vertices, in both directions.
+    *
+    * A distance matrix of edge weights only has its two entries updated. If getDistance returned shortest path distances
+    * (from a road matrix, the contraction hierarchy or the distance cache), it keeps doing so with the new weights: the
+    * road matrix and the hierarchy would keep the old distances, so they are dropped and the distances come from the
+    * bidirectional A* and the distance cache. The A* is built in O(|V| + |E|) only if there was none, and is otherwise
+    * patched in place, while the cache is emptied. The hierarchy is then marked stale until buildHierarchy is called
+    * again. DynamicMST::update calls this function, so the tours see the new weights too.
+    *
+    * @param sourc The ID of one end of the edge.
+    * @param dest The ID of the other end of the edge.
+    * @param w The new weight.
+    * @return True if the edge exists, false otherwise.
+    * @complexity O(deg(sourc) + deg(dest)) without shortest path distances, O(deg(sourc) + deg(dest) + c) with them, where c
+    * is the number of cached pairs, plus O(|V| + |E|) on the first update that builds the A*.
+    */
+    bool setEdgeWeight(const int &sourc, const int &dest, double w);
+
+    /**
+    * @brief Checks if the contraction hierarchy was dropped by setEdgeWeight, in which case the distances it gave are
+    * computed by the bidirectional A* until buildHierarchy is called again.
+    * @complexity O(1)
+    */
+    bool isHierarchyStale() const;
+
     /**
     * @brief Returns the number of vertices in the graph.
     *
@@ -113,48 +167,311 @@ public:
     */
     std::unordered_map<int, Vertex*> getVertexSet() const;
 
+    /**
+    * @brief Returns the distance between two vertices of the graph.
+    *
+    * Uses the distance matrix when it has been built. Otherwise, with the distance cache enabled, looks the pair up in the cache
+    * and on a miss computes its shortest path distance (with the contraction hierarchy when there is one, or a bidirectional A*)
+    * and stores it. Without the cache, uses the contraction hierarchy when there is one. Pairs with no path, and every pair when
+    * there is neither, fall back to the edge weight (or the haversine distance when the vertices are not connected).
+    *
+    * @param sourc The ID of the source vertex.
+    * @param dest The ID of the destination vertex.
+    * @return The distance between the two vertices.
+    * @complexity O(1) with the distance matrix or on a cache hit, a bidirectional search of a few hundred vertices with the hierarchy,
+    * a bidirectional A* on a cache miss without it, O(|E|) otherwise, where |E| is the number of outgoing edges from the source.
+    */
+    double getDistance(const int &sourc, const int &dest) const;
+
+    /**
+    * @brief Fills the distance matrix with the weight between every pair of vertices.
+    *
+    * Pairs that are not connected by an edge get the haversine distance, so the matrix agrees with Vertex::getEdgeWeight.
+    * When the graph has a contraction hierarchy or the distance cache, the matrix is filled by buildRoadDistances instead, so it agrees with getDistance,
+    * without the path matrix.
+    * The vertex IDs must be 0 to |V| - 1.
+    *
+    * @return True if the matrix was built, false if the vertex IDs are not contiguous.
+    * @complexity O(|V|^2 + |E|), where |V| is the number of vertices and |E| the number of edges in the graph.
+    */
+    bool buildDistMatrix();
+
+    /**
+    * @brief Checks if the distance matrix has been built.
+    * @return True if the distance matrix is available, false otherwise.
+    * @complexity O(1)
+    */
+    bool hasDistMatrix() const;
+
+    /**
+    * @brief Fills the distance matrix with the shortest path distances (the metric closure) using a blocked Floyd-Warshall.
+    *
+    * The matrices are split in FW_BLOCK x FW_BLOCK tiles that fit in the L1 cache. For every block k, the diagonal tile is
+    * relaxed first, then the tiles in its row and column, then every other tile; the tiles of the last two phases do not
+    * write to each other, so they are spread over the threads. The path matrix keeps the next vertex of every shortest
+    * path, for getShortestPath. Pairs with no path get the haversine distance, like Vertex::getEdgeWeight.
+    * The vertex IDs must be 0 to |V| - 1.
+    *
+    * @param threads The number of threads, or 0 to use one per hardware thread.
+    * @return True if the matrices were built, false if the vertex IDs are not contiguous.
+    * @complexity O(|V|^3 / threads) time and O(|V|^2) memory.
+    */
+    bool buildShortestPaths(unsigned int threads = 0);
+
+    /**
+    * @brief Reconstructs a shortest path from the path matrix filled by buildShortestPaths.
+    * @param sourc The ID of the source vertex.
+    * @param dest The ID of the destination vertex.
+    * @return The IDs of the vertices of the path, from sourc to dest, or an empty vector if there is no path or no path matrix.
+    * @complexity O(|V|)
+    */
+    std::vector<int> getShortestPath(const int &sourc, const int &dest) const;
+
+    /**
+    * @brief Fills the distance and path matrices like buildShortestPaths, with one Dijkstra per source on a pool of threads.
+    *
+    * On sparse graphs this is much faster than Floyd-Warshall. Each thread takes the next source, runs Dijkstra with its
+    * own queue and labels and writes the row of the source straight into the matrices. The vertex IDs must be 0 to |V| - 1.
+    *
+    * @param threads The number of threads, or 0 to use one per hardware thread.
+    * @param paths False to fill only the distance matrix, for callers that never reconstruct a path with getShortestPath.
+    * @return True if the matrices were built, false if the vertex IDs are not contiguous.
+    * @complexity O(|V| * (|V| + |E|) log |V| / threads) time and O(|V|^2) memory.
+    */
+    bool buildRoadDistances(unsigned int threads = 0, bool paths = true);
+
+    /**
+    * @brief Computes the shortest path distances between every pair of a subset of the vertices, with one Dijkstra per vertex of the subset.
+    *
+    * Each search stops as soon as it has reached every vertex of the subset, and pairs with no path get the haversine distance.
+    * The graph is not changed, so large graphs can be restricted to the vertices of interest without an |V| x |V| matrix.
+    *
+    * @param vertices The distinct IDs of the vertices of the subset.
+    * @param threads The number of threads, or 0 to use one per hardware thread.
+    * @return The matrix of distances, where entry [a][b] is the distance from vertices[a] to vertices[b], or an empty matrix if the vertex IDs are not 0 to |V| - 1 or the subset has an unknown or repeated ID.
+    * @complexity O(k * (|V| + |E|) log |V| / threads) time in the worst case and O(k^2 + threads * |V|) memory, where k is the size of the subset.
+    */
+    std::vector<std::vector<double>> getRoadDistances(const std::vector<int> &vertices, unsigned int threads = 0) const;
+
+    /**
+    * @brief Builds the contraction hierarchy of the graph, after which getDistance returns shortest path distances.
+    *
+    * The hierarchy treats the graph as undirected, like the graphs loaded by Data. The vertex IDs must be 0 to |V| - 1.
+    *
+    * @return True if the hierarchy was built, false if the vertex IDs are not contiguous.
+    * @complexity Near-linear on road networks, see ContractionHierarchy.
+    */
+    bool buildHierarchy();
+
+    /**
+    * @brief Checks if the graph is sparse enough for a contraction hierarchy, with at most HIERARCHY_MAX_DEGREE edges per
+    * vertex on average. The contraction is near-linear on road networks but super-cubic on dense graphs.
+    * @complexity O(|V|)
+    */
+    bool isSparse() const;
+
+    /**
+    * @brief Saves the contraction hierarchy to a csv file, so it can be loaded next time instead of built.
+    * @param filename The name of the file.
+    * @return True if the graph has a hierarchy and the file was written.
+    * @complexity O(|V| + |E|)
+    */
+    bool saveHierarchy(const std::string &filename) const;
+
+    /**
+    * @brief Loads the contraction hierarchy saved by saveHierarchy.
+    * @param filename The name of the file.
+    * @return True if the file exists and was saved for a graph with the same number of vertices and the same edge checksum,
+    * computed from the endpoints and the weight of every edge.
+    * @complexity O(|V| + |E|)
+    */
+    bool loadHierarchy(const std::string &filename);
+
+    /**
+    * @brief Checks if the graph has a contraction hierarchy.
+    * @complexity O(1)
+    */
+    bool hasHierarchy() const;
+
+    /**
+    * @brief Enables the exact shortest path distances computed on demand, memoized in a bounded LRU cache.
+    *
+    * No preprocessing is needed: the first lookup of a pair runs a bidirectional A* guided by the haversine distance
+    * (or queries the contraction hierarchy, if there is one) and later lookups of the pair hit the cache.
+    * The vertex IDs must be 0 to |V| - 1.
+    *
+    * @param capacity The maximum number of pairs kept in the cache.
+    * @return True if the cache was enabled, false if the vertex IDs are not contiguous.
+    * @complexity O(|V| + |E|)
+    */
+    bool enableDistanceCache(std::size_t capacity = DISTANCE_CACHE_CAPACITY);
+
+    /**
+    * @brief Returns the distance cache, or nullptr if it is not enabled.
+    * @complexity O(1)
+    */
+    DistanceCache *getDistanceCache() const;
+
+    /**
+    * @brief Computes the length of a tour over the vertices of the graph.
+    * @param tour The tour, whose cities are the vertex IDs.
+    * @return The length of the tour, including the edge back to the first vertex.
+    * @complexity O(|V|) with the distance matrix, O(|V| * |E|) otherwise.
+    */
+    double getTourLength(const Tour &tour) const;
+
     /**
     * @brief Computes the minimum spanning tree (MST) of the graph using Prim's algorithm.
     *
-    * @param source The ID of the source vertex.
-    * @return A list of vertices representing the MST.
-    * @complexity O(|V|^2), where |V| is the number of vertices in the graph.
+    * The keys and visited marks are local to the call instead of fields of the vertices, so it is safe to call from several threads at once.
+    *
+    * @param source The ID of the source vertex, which is the root of the tree.
+    * @return The MST as a RootedTree, with the parent, children, degree and preorder of every vertex.
+    * @complexity O(|E| log |V|), where |V| is the number of vertices and |E| the number of edges in the graph.
     */
-    std::list<Vertex *> prim(const int & source);
+    RootedTree prim(const int & source) const;
 
     /**
      * Finds a TSP tour using an approximation algorithm based on the Triangular Inequality.
-     * The algorithm starts from the given source vertex ID.
+     * The algorithm starts from the given source vertex ID. Safe to call from several threads at once.
      *
      * @param source The ID of the source vertex.
-    * @return A vector of vertices representing the approximate TSP tour.
+    * @return The approximate TSP tour.
     * @complexity O(|V|^2), where |V| is the number of vertices in the graph.
     */
-    std::vector<Vertex *> tourTriangApproxTsp(const int &source);
+    Tour tourTriangApproxTsp(const int &source) const;
+
+    /**
+    * @brief Finds a TSP tour from the preorder of a given spanning tree, such as the one kept by DynamicMST.
+    *
+    * @param mst The minimum spanning tree, whose root is the first vertex of the tour.
+    * @return The approximate TSP tour, empty if the tree does not span the graph.
+    * @complexity O(|V|)
+    */
+    Tour tourTriangApproxTsp(const RootedTree &mst) const;
 
     /**
     * @brief Computes an approximate solution to the Traveling Salesman Problem (TSP) using a minimum spanning tree (MST) and a heuristic algorithm.
     *
+    * Safe to call from several threads at once.
+    *
     * @param source The ID of the source vertex.
-    * @return A vector of vertices representing the approximate TSP tour.
+    * @return The approximate TSP tour.
     * @complexity O(|V|^2), where |V| is the number of vertices in the graph.
     */
-    std::vector<Vertex *> tourHeuristicApproxTsp(const int &source);
+    Tour tourHeuristicApproxTsp(const int &source) const;
+
+    /**
+    * @brief Computes the tour of the heuristic approximation from a given spanning tree, such as the one kept by DynamicMST.
+    *
+    * @param mst The minimum spanning tree, whose root is the first vertex of the tour. Every vertex must come after its parent in its order.
+    * @return The approximate TSP tour, empty if the tree does not span the graph.
+    * @complexity O(|V| log |V| + |E|)
+    */
+    Tour tourHeuristicApproxTsp(const RootedTree &mst) const;
 
     /**
     * @brief Computes an approximate solution to the Traveling Salesman Problem (TSP) using a minimum spanning tree (MST) and the Christofides algorithm.
     *
+    * The odd-degree vertices of the MST are matched with the exact (blossom) method of PerfectMatching.
+    *
     * @param source The ID of the source vertex.
-    * @return A vector of vertices representing the approximate TSP tour.
-    * @complexity O(|V|^2), where |V| is the number of vertices in the graph.
+    * @return The approximate TSP tour.
+    * @complexity O(|V|^2 + k^3), where |V| is the number of vertices in the graph and k the number of odd-degree vertices of the MST.
+    */
+    Tour tourChristofidesApproxTsp(const int &source);
+
+    /**
+    * @brief Computes an approximate solution to the Traveling Salesman Problem (TSP) using the Christofides algorithm with a chosen matching method.
+    *
+    * The matched pairs of odd-degree vertices do not need to be edges of the graph, so it also runs on graphs that are not complete.
+    *
+    * @param source The ID of the source vertex.
+    * @param method The algorithm used to match the odd-degree vertices of the MST.
+    * @param matchingCost[out] The total distance of the matched pairs.
+    * @param matchingTime[out] The time taken by the matching, in seconds.
+    * @return The approximate TSP tour.
+    * @complexity O(|V|^2 + k^3) with the exact matching and O(|V|^2 + k^2) with the greedy matching, where k is the number of odd-degree vertices of the MST.
+    */
+    Tour tourChristofidesApproxTsp(const int &source, MatchingMethod method, double &matchingCost, double &matchingTime);
+
+    /**
+    * @brief Computes the tour of the Christofides algorithm from a given spanning tree, such as the one kept by DynamicMST.
+    *
+    * @param mst The minimum spanning tree, whose root is the first vertex of the tour.
+    * @param method The algorithm used to match the odd-degree vertices of the MST.
+    * @param matchingCost[out] The total distance of the matched pairs.
+    * @param matchingTime[out] The time taken by the matching, in seconds.
+    * @return The approximate TSP tour, empty if the tree does not span the graph.
+    * @complexity O(|V| + k^3) with the exact matching and O(|V| + k^2) with the greedy matching, where k is the number of odd-degree vertices of the MST.
     */
-    std::vector<Vertex *> tourChristofidesApproxTsp(const int &source);
+    Tour tourChristofidesApproxTsp(const RootedTree &mst, MatchingMethod method, double &matchingCost, double &matchingTime);
+
+    /**
+    * @brief Computes an approximate solution to the Traveling Salesman Problem (TSP) using the greedy-edge (multi-fragment) heuristic.
+    *
+    * The edges of the graph are sorted once by weight and each one is accepted if both endpoints have degree below 2
+    * and it does not close a cycle, which is checked with a UFDS. The resulting fragments are then joined into a tour,
+    * always moving from the end of a fragment to the closest endpoint of a fragment that was not visited yet.
+    *
+    * @return The approximate TSP tour.
+    * @complexity O(|E| log |E| + f^2), where f is the number of fragments left by the greedy phase.
+    */
+    Tour tourGreedyEdgeTsp();
+
+    /**
+    * @brief Computes a TSP tour that visits the vertices in the order of a Hilbert space-filling curve over their coordinates.
+    *
+    * The longitude (scaled by the cosine of the mean latitude) and the latitude of every vertex are mapped to a
+    * 2^32 x 2^32 grid, encoded as the 64-bit index of their cell along the Hilbert curve and radix-sorted.
+    * Meant for graphs with coordinates, such as the ones loaded by createRealGraph; the tour does not depend on the edges.
+    *
+    * @return The approximate TSP tour.
+    * @complexity O(|V|)
+    */
+    Tour tourHilbertTsp() const;
+
+    /**
+    * @brief Computes an approximate solution to the Traveling Salesman Problem (TSP) by inserting one vertex at a time in a growing tour.
+    *
+    * The key of every vertex that is not in the tour (its distance to the tour, or its cheapest insertion cost) is
+    * kept in a MutablePriorityQueue and updated after each insertion with the edges that changed, instead of
+    * rescanning every tour edge for every vertex. The chosen vertex is inserted where it increases the tour the least.
+    * With cheapest insertion, only the vertices whose best edge was removed rescan the tour.
+    *
+    * @param source The ID of the vertex the tour starts with.
+    * @param rule The rule that chooses the next vertex to insert.
+    * @return The approximate TSP tour.
+    * @complexity O(|V|^2 log |V|) with the distance matrix.
+    */
+    Tour tourInsertionTsp(const int &source, InsertionRule rule);
+
+    /**
+    * @brief Computes an approximate solution to the Traveling Salesman Problem (TSP) using the Clarke-Wright savings algorithm.
+    *
+    * Every vertex starts in its own route through the depot, and the routes are merged along the edges {i, j} with the
+    * largest saving d(depot, i) + d(depot, j) - d(i, j), as long as i and j are route ends of different routes.
+    * The distances d are those of getDistance, so the savings and the joining of the routes use the same metric.
+    * Instead of sorting all the |V|^2 / 2 savings, each vertex only keeps the savings of its SAVINGS_CANDIDATES nearest
+    * neighbours, sorted by decreasing saving, and a priority queue holds only the next saving of each vertex. The routes
+    * left when the candidates run out are joined like the fragments of tourGreedyEdgeTsp.
+    *
+    * @param depot The ID of the depot vertex, which is the first vertex of the tour.
+    * @return The approximate TSP tour.
+    * @complexity O(|E| + |V| * SAVINGS_CANDIDATES * log |V| + f^2) time and O(|V| * SAVINGS_CANDIDATES) memory, where f is the number of routes left.
+    */
+    Tour tourSavingsTsp(const int &depot);
 
 protected:
     std::unordered_map<int, Vertex*> vertexSet;    // vertex set
 
     double ** distMatrix = nullptr;   // dist matrix for Floyd-Warshall
     int **pathMatrix = nullptr;   // path matrix for Floyd-Warshall
+    bool roadMatrix = false;      // the dist matrix holds shortest path distances instead of edge weights
+    bool hierarchyStale = false;  // the hierarchy was dropped by an edge weight update and not rebuilt
+    std::unique_ptr<ContractionHierarchy> hierarchy;   // shortest path distances without a matrix
+    std::unique_ptr<BidirectionalAStar> aStar;         // shortest path distances without preprocessing
+    std::unique_ptr<DistanceCache> distanceCache;      // memoized shortest path distances
 
     /*
      * Finds the index of the vertex with a given content.
@@ -169,39 +486,55 @@ protected:
     int findVertexIdx(const int &id) const;
 
     /**
-    * @brief Helper function for depth-first search (DFS) traversal of the graph.
+    * @brief Runs one Dijkstra per source on a pool of threads, each with its own MutablePriorityQueue and labels.
     *
-    * @param v The current vertex being visited.
-    * @param tour The vector to store the DFS traversal.
-    * @complexity O(|V|^2), where |V| is the number of vertices in the graph.
+    * @param sources The IDs of the sources, where row r of the matrices belongs to sources[r].
+    * @param targets The IDs of the targets, where column c of the matrices belongs to targets[c].
+    * @param dist[out] The distance matrix, where pairs with no path get the haversine distance.
+    * @param next[out] The first vertex after the source on each path, or -1 if there is no path. It may be nullptr.
+    * @param threads The number of threads, or 0 to use one per hardware thread.
+    * @complexity O(|sources| * (|V| + |E|) log |V| / threads)
     */
-    void dfsVisit(Vertex *v, std::vector<Vertex *> &tour) const;
+    void dijkstraRows(const std::vector<int> &sources, const std::vector<int> &targets, double **dist, int **next, unsigned int threads) const;
 
     /**
     * @brief Helper function for the heuristic algorithm to visit the graph vertices and form cycles.
     *
-    * @param v The current vertex being visited.
-    * @param tour The vector to store the visited vertices forming cycles.
-    * @param numVert The number of vertices visited so far.
-    * @complexity O(|V|^2), where |V| is the number of vertices in the graph.
+    * Walks down to the first unvisited child of each vertex and, when there is none, jumps to the closest unvisited vertex,
+    * until every vertex is visited. The walk is a loop, so it does not grow the call stack. When every neighbour of a vertex
+    * was visited, the closest unvisited vertex by coordinates is taken from a KdTree.
+    *
+    * @param v The vertex where the walk starts.
+    * @param tree The tree built by heuristicVisit.
+    * @param order The vector to store the IDs of the visited vertices forming cycles.
+    * @complexity O(|V| log |V| + |E|)
     */
-    void dfsVisitCycles(Vertex *v, std::vector<Vertex *> &tour, int numVert) const;
+    void dfsVisitCycles(Vertex *v, const RootedTree &tree, std::vector<int> &order) const;
+
     /**
     * @brief Helper function for the heuristic algorithm to visit the minimum spanning tree (MST) vertices.
     *
+    * Visits the vertices in the order Prim's algorithm added them and, when the parent of a vertex was already taken by
+    * another vertex, reattaches the vertex to its closest neighbour that was not taken yet.
+    *
     * @param mst The minimum spanning tree (MST) of the graph.
-    * @complexity O(|V|^2), where |V| is the number of vertices in the graph.
+    * @return The tree with the new parents, which may contain cycles away from the root.
+    * @complexity O(|V| log |V| + |E|)
     */
-    void heuristicVisit(std::list<Vertex *> &mst);
+    RootedTree heuristicVisit(const RootedTree &mst) const;
 
     /**
-    * @brief Helper function for the Christofides algorithm to visit the graph vertices.
+    * @brief Helper function for the Christofides algorithm that builds the tour from an Euler circuit of the MST and the matched pairs.
     *
-    * @param v The current vertex being visited.
-    * @param eulerian The eulerian path.
-    * @complexity O(|V|^2), where |V| is the number of vertices in the graph.
+    * The MST edges and the matched pairs are stored as an explicit multigraph with an incidence list and an edge cursor
+    * per vertex, so Hierholzer's algorithm never looks at an edge twice. The circuit is shortcut in the same pass.
+    *
+    * @param mst The minimum spanning tree, as returned by prim.
+    * @param mate The vertex matched with each vertex, or -1.
+    * @param order[out] The vertices of the tour, in order.
+    * @complexity O(|V|), since the multigraph has less than 2|V| edges.
     */
-    void christofidesVisit(Vertex *v, std::vector<Vertex *> &eulerian) const;
+    void christofidesVisit(const RootedTree &mst, const std::vector<int> &mate, std::vector<int> &order) const;
 };
 
 /**
@@ -0,0 +1,155 @@
+#include "KdTree.h"
+
+#include <algorithm>
+#include <numeric>
+#include <limits>
+
+KdTree::KdTree(const std::vector<std::pair<double, double>> &points): n(points.size()), ids(n), xs(n), ys(n), position(n), alive(n), removed(n, false) {
+    std::iota(ids.begin(), ids.end(), 0);
+    for (int i = 0; i < n; i++) {
+        xs[i] = points[i].first;
+        ys[i] = points[i].second;
+    }
+    build(0, n, 0);
+
+    // from here on xs and ys are indexed by position in the tree
+    std::vector<double> x(n), y(n);
+    for (int p = 0; p < n; p++) {
+        position[ids[p]] = p;
+        x[p] = xs[ids[p]];
+        y[p] = ys[ids[p]];
+    }
+    xs.swap(x);
+    ys.swap(y);
+}
+
+void KdTree::build(int lo, int hi, int depth) {
+    if (lo >= hi) {
+        return;
+    }
+
+    // the node of the range [lo, hi) is its middle position, which holds the median along the split axis
+    int mid = lo + (hi - lo) / 2;
+    const std::vector<double> &axis = depth % 2 == 0 ? xs : ys;
+    std::nth_element(ids.begin() + lo, ids.begin() + mid, ids.begin() + hi, [&axis](int a, int b) {
+        return axis[a] < axis[b];
+    });
+    alive[mid] = hi - lo;
+
+    build(lo, mid, depth + 1);
+    build(mid + 1, hi, depth + 1);
+}
+
+void KdTree::remove(int i) {
+    int target = position[i];
+    if (removed[target]) {
+        return;
+    }
+    removed[target] = true;
+
+    int lo = 0, hi = n;
+    while (true) {
+        int mid = lo + (hi - lo) / 2;
+        alive[mid]--;
+        if (target == mid) break;
+        if (target < mid) hi = mid;
+        else lo = mid + 1;
+    }
+}
+
+void KdTree::restore(int i) {
+    int target = position[i];
+    if (!removed[target]) {
+        return;
+    }
+    removed[target] = false;
+
+    int lo = 0, hi = n;
+    while (true) {
+        int mid = lo + (hi - lo) / 2;
+        alive[mid]++;
+        if (target == mid) break;
+        if (target < mid) hi = mid;
+        else lo = mid + 1;
+    }
+}
+
+int KdTree::nearest(double x, double y) const {
+    int best = -1;
+    double bestDist = std::numeric_limits<double>::max();
+    nearest(0, n, 0, x, y, best, bestDist);
+    return best < 0 ? -1 : ids[best];
+}
+
+void KdTree::nearest(int lo, int hi, int depth, double x, double y, int &best, double &bestDist) const {
+    if (lo >= hi) {
+        return;
+    }
+    int mid = lo + (hi - lo) / 2;
+    if (alive[mid] == 0) {
+        return;
+    }
+
+    if (!removed[mid]) {
+        double dist = (xs[mid] - x) * (xs[mid] - x) + (ys[mid] - y) * (ys[mid] - y);
+        if (dist < bestDist) {
+            bestDist = dist;
+            best = mid;
+        }
+    }
+
+    // the side of the split that holds (x, y) first, and the other side only if it can hold a closer point
+    double diff = depth % 2 == 0 ? x - xs[mid] : y - ys[mid];
+    if (diff < 0) {
+        nearest(lo, mid, depth + 1, x, y, best, bestDist);
+        if (diff * diff < bestDist) nearest(mid + 1, hi, depth + 1, x, y, best, bestDist);
+    } else {
+        nearest(mid + 1, hi, depth + 1, x, y, best, bestDist);
+        if (diff * diff < bestDist) nearest(lo, mid, depth + 1, x, y, best, bestDist);
+    }
+}
+
+std::vector<int> KdTree::nearest(double x, double y, int k) const {
+    // a max-heap of the k closest points so far, so its top is the distance a subtree has to beat
+    std::vector<std::pair<double, int>> heap;
+    if (k > 0) {
+        nearest(0, n, 0, x, y, k, heap);
+    }
+    std::sort_heap(heap.begin(), heap.end());
+
+    std::vector<int> result;
+    for (auto &entry : heap) {
+        result.push_back(ids[entry.second]);
+    }
+    return result;
+}
+
+void KdTree::nearest(int lo, int hi, int depth, double x, double y, int k, std::vector<std::pair<double, int>> &heap) const {
+    if (lo >= hi) {
+        return;
+    }
+    int mid = lo + (hi - lo) / 2;
+    if (alive[mid] == 0) {
+        return;
+    }
+
+    if (!removed[mid]) {
+        double dist = (xs[mid] - x) * (xs[mid] - x) + (ys[mid] - y) * (ys[mid] - y);
+        if ((int) heap.size() < k) {
+            heap.push_back({dist, mid});
+            std::push_heap(heap.begin(), heap.end());
+        } else if (dist < heap.front().first) {
+            std::pop_heap(heap.begin(), heap.end());
+            heap.back() = {dist, mid};
+            std::push_heap(heap.begin(), heap.end());
+        }
+    }
+
+    double diff = depth % 2 == 0 ? x - xs[mid] : y - ys[mid];
+    int nearLo = diff < 0 ? lo : mid + 1, nearHi = diff < 0 ? mid : hi;
+    int farLo = diff < 0 ? mid + 1 : lo, farHi = diff < 0 ? hi : mid;
+    nearest(nearLo, nearHi, depth + 1, x, y, k, heap);
+    if ((int) heap.size() < k || diff * diff < heap.front().first) {
+        nearest(farLo, farHi, depth + 1, x, y, k, heap);
+    }
+}
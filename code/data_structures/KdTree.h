@@ -0,0 +1,76 @@
+#ifndef ROUTING_ALGORITHM_KD_TREE_H
+#define ROUTING_ALGORITHM_KD_TREE_H
+
+/**
+* @file KdTree.h
+* @brief Contains the declaration of the KdTree class.
+* @author Luiz, Pedro e Raphael
+* @date 02/06/2023
+*/
+
+#include <vector>
+#include <utility>
+
+/**
+ * @class KdTree
+ * @brief A 2-d tree over a fixed set of points in the plane that answers nearest-point queries and supports removing points.
+ *
+ * The tree is implicit: the points are reordered so that the median of every range splits it, and each node keeps
+ * the number of points of its range that were not removed, so empty subtrees are skipped by the queries.
+ */
+class KdTree {
+public:
+    /**
+    * @brief Constructs a KdTree over a set of points.
+    * @param points The coordinates of the points, which are identified by their index.
+    * @complexity O(n log n)
+    */
+    explicit KdTree(const std::vector<std::pair<double, double>> &points);
+
+    /**
+    * @brief Removes a point from the tree. Removing a point twice has no effect.
+    * @param i The index of the point.
+    * @complexity O(log n)
+    */
+    void remove(int i);
+
+    /**
+    * @brief Restores a removed point. Restoring a point that was not removed has no effect.
+    * @param i The index of the point.
+    * @complexity O(log n)
+    */
+    void restore(int i);
+
+    /**
+    * @brief Finds the point closest to (x, y) that was not removed.
+    * @param x The first coordinate.
+    * @param y The second coordinate.
+    * @return The index of the closest point, or -1 if every point was removed.
+    * @complexity O(log n) on average for points spread over the plane.
+    */
+    int nearest(double x, double y) const;
+
+    /**
+    * @brief Finds the k points closest to (x, y) that were not removed. Safe to call from several threads at once.
+    * @param x The first coordinate.
+    * @param y The second coordinate.
+    * @param k The number of points.
+    * @return The indices of the closest points, sorted by increasing distance, or every point left if there are less than k.
+    * @complexity O(k log k log n) on average for points spread over the plane.
+    */
+    std::vector<int> nearest(double x, double y, int k) const;
+
+private:
+    int n;
+    std::vector<int> ids;
+    std::vector<double> xs, ys;
+    std::vector<int> position;
+    std::vector<int> alive;
+    std::vector<bool> removed;
+
+    void build(int lo, int hi, int depth);
+    void nearest(int lo, int hi, int depth, double x, double y, int &best, double &bestDist) const;
+    void nearest(int lo, int hi, int depth, double x, double y, int k, std::vector<std::pair<double, int>> &heap) const;
+};
+
+#endif
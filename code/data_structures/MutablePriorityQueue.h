@@ -56,6 +56,12 @@ public:
     */
 	void decreaseKey(T * x);
 
+    /**
+    * @brief Increases the key of an element in the priority queue.
+    * @param x A pointer to the element whose key is to be increased.
+    */
+	void increaseKey(T * x);
+
     /**
     * @brief Checks if the priority queue is empty.
     * @return `true` if the priority queue is empty, `false` otherwise.
@@ -100,6 +106,11 @@ void MutablePriorityQueue<T>::decreaseKey(T *x) {
 	heapifyUp(x->queueIndex);
 }
 
+template <class T>
+void MutablePriorityQueue<T>::increaseKey(T *x) {
+	heapifyDown(x->queueIndex);
+}
+
 template <class T>
 void MutablePriorityQueue<T>::heapifyUp(unsigned i) {
 	auto x = H[i];
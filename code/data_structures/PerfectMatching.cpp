@@ -0,0 +1,446 @@
+#include "PerfectMatching.h"
+#include "Graph.h"
+
+#include <chrono>
+#include <climits>
+#include <deque>
+#include <queue>
+
+#define EPSILON 1e-7
+
+namespace {
+
+/**
+ * @brief Maximum-weight matching of a complete graph with Edmonds' blossom algorithm and the primal-dual method, in O(n^3).
+ *
+ * Vertices are numbered 1 to n and blossoms n + 1 to 2n, with 0 meaning none. All weights are positive, so the
+ * maximum-weight matching of a complete graph with an even number of vertices is perfect.
+ */
+class Blossom {
+public:
+    explicit Blossom(int n): n(n), count(n), g(2 * n + 1, std::vector<BlossomEdge>(2 * n + 1)), label(2 * n + 1, 0),
+        match(2 * n + 1, 0), slack(2 * n + 1, 0), base(2 * n + 1, 0), predecessor(2 * n + 1, 0), side(2 * n + 1, 0),
+        mark(2 * n + 1, 0), from(2 * n + 1, std::vector<int>(n + 1, 0)), flower(2 * n + 1) {
+        for (int u = 1; u <= n; u++) {
+            for (int v = 1; v <= n; v++) {
+                g[u][v] = {u, v, 0};
+            }
+        }
+    }
+
+    void setWeight(int u, int v, long long w) {
+        g[u][v].w = g[v][u].w = w;
+    }
+
+    /**
+    * @return The partner of every vertex, indexed from 1.
+    */
+    std::vector<int> solve() {
+        long long maxWeight = 0;
+        for (int u = 0; u <= n; u++) {
+            base[u] = u;
+            flower[u].clear();
+        }
+        for (int u = 1; u <= n; u++) {
+            for (int v = 1; v <= n; v++) {
+                from[u][v] = u == v ? u : 0;
+                maxWeight = std::max(maxWeight, g[u][v].w);
+            }
+        }
+        for (int u = 1; u <= n; u++) {
+            label[u] = maxWeight;
+        }
+        while (augmentingPath());
+        return match;
+    }
+
+private:
+    struct BlossomEdge {
+        int u, v;
+        long long w;
+    };
+
+    int n, count, stamp = 0;
+    std::vector<std::vector<BlossomEdge>> g;
+    std::vector<long long> label;
+    // side is -1 for unreached, 0 for even (outer) and 1 for odd (inner) vertices and blossoms
+    std::vector<int> match, slack, base, predecessor, side, mark;
+    std::vector<std::vector<int>> from, flower;
+    std::queue<int> q;
+
+    long long delta(const BlossomEdge &e) const {
+        return label[e.u] + label[e.v] - 2 * g[e.u][e.v].w;
+    }
+
+    void updateSlack(int u, int x) {
+        if (slack[x] == 0 || delta(g[u][x]) < delta(g[slack[x]][x])) slack[x] = u;
+    }
+
+    void setSlack(int x) {
+        slack[x] = 0;
+        for (int u = 1; u <= n; u++) {
+            if (g[u][x].w > 0 && base[u] != x && side[base[u]] == 0) updateSlack(u, x);
+        }
+    }
+
+    void push(int x) {
+        if (x <= n) q.push(x);
+        else for (int y : flower[x]) push(y);
+    }
+
+    void setBase(int x, int b) {
+        base[x] = b;
+        if (x > n) for (int y : flower[x]) setBase(y, b);
+    }
+
+    int position(int b, int x) {
+        int p = std::find(flower[b].begin(), flower[b].end(), x) - flower[b].begin();
+        if (p % 2 == 1) {
+            std::reverse(flower[b].begin() + 1, flower[b].end());
+            return (int) flower[b].size() - p;
+        }
+        return p;
+    }
+
+    void setMatch(int u, int v) {
+        match[u] = g[u][v].v;
+        if (u <= n) return;
+        BlossomEdge e = g[u][v];
+        int x = from[u][e.u], p = position(u, x);
+        for (int i = 0; i < p; i++) setMatch(flower[u][i], flower[u][i ^ 1]);
+        setMatch(x, v);
+        std::rotate(flower[u].begin(), flower[u].begin() + p, flower[u].end());
+    }
+
+    void augment(int u, int v) {
+        while (true) {
+            int x = base[match[u]];
+            setMatch(u, v);
+            if (x == 0) return;
+            setMatch(x, base[predecessor[x]]);
+            u = base[predecessor[x]];
+            v = x;
+        }
+    }
+
+    int lowestCommonAncestor(int u, int v) {
+        for (++stamp; u != 0 || v != 0; std::swap(u, v)) {
+            if (u == 0) continue;
+            if (mark[u] == stamp) return u;
+            mark[u] = stamp;
+            u = base[match[u]];
+            if (u != 0) u = base[predecessor[u]];
+        }
+        return 0;
+    }
+
+    void addBlossom(int u, int ancestor, int v) {
+        int b = n + 1;
+        while (b <= count && base[b] != 0) b++;
+        if (b > count) count++;
+        label[b] = 0;
+        side[b] = 0;
+        match[b] = match[ancestor];
+        flower[b].clear();
+        flower[b].push_back(ancestor);
+        for (int x = u, y; x != ancestor; x = base[predecessor[y]]) {
+            flower[b].push_back(x);
+            flower[b].push_back(y = base[match[x]]);
+            push(y);
+        }
+        std::reverse(flower[b].begin() + 1, flower[b].end());
+        for (int x = v, y; x != ancestor; x = base[predecessor[y]]) {
+            flower[b].push_back(x);
+            flower[b].push_back(y = base[match[x]]);
+            push(y);
+        }
+        setBase(b, b);
+        for (int x = 1; x <= count; x++) g[b][x].w = g[x][b].w = 0;
+        for (int x = 1; x <= n; x++) from[b][x] = 0;
+        for (int y : flower[b]) {
+            for (int x = 1; x <= count; x++) {
+                if (g[b][x].w == 0 || delta(g[y][x]) < delta(g[b][x])) {
+                    g[b][x] = g[y][x];
+                    g[x][b] = g[x][y];
+                }
+            }
+            for (int x = 1; x <= n; x++) {
+                if (from[y][x] != 0) from[b][x] = y;
+            }
+        }
+        setSlack(b);
+    }
+
+    void expandBlossom(int b) {
+        for (int y : flower[b]) setBase(y, y);
+        int x = from[b][g[b][predecessor[b]].u], p = position(b, x);
+        for (int i = 0; i < p; i += 2) {
+            int y = flower[b][i], z = flower[b][i + 1];
+            predecessor[y] = g[z][y].u;
+            side[y] = 1;
+            side[z] = 0;
+            slack[y] = 0;
+            setSlack(z);
+            push(z);
+        }
+        side[x] = 1;
+        predecessor[x] = predecessor[b];
+        for (int i = p + 1; i < (int) flower[b].size(); i++) {
+            int y = flower[b][i];
+            side[y] = -1;
+            setSlack(y);
+        }
+        base[b] = 0;
+    }
+
+    bool onTightEdge(const BlossomEdge &e) {
+        int u = base[e.u], v = base[e.v];
+        if (side[v] == -1) {
+            predecessor[v] = e.u;
+            side[v] = 1;
+            int w = base[match[v]];
+            slack[v] = slack[w] = 0;
+            side[w] = 0;
+            push(w);
+        } else if (side[v] == 0) {
+            int ancestor = lowestCommonAncestor(u, v);
+            if (ancestor == 0) {
+                augment(u, v);
+                augment(v, u);
+                return true;
+            }
+            addBlossom(u, ancestor, v);
+        }
+        return false;
+    }
+
+    bool augmentingPath() {
+        std::fill(side.begin() + 1, side.begin() + count + 1, -1);
+        std::fill(slack.begin() + 1, slack.begin() + count + 1, 0);
+        q = std::queue<int>();
+        for (int x = 1; x <= count; x++) {
+            if (base[x] == x && match[x] == 0) {
+                predecessor[x] = 0;
+                side[x] = 0;
+                push(x);
+            }
+        }
+        if (q.empty()) return false;
+
+        while (true) {
+            while (!q.empty()) {
+                int u = q.front();
+                q.pop();
+                if (side[base[u]] == 1) continue;
+                for (int v = 1; v <= n; v++) {
+                    if (g[u][v].w > 0 && base[u] != base[v]) {
+                        if (delta(g[u][v]) == 0) {
+                            if (onTightEdge(g[u][v])) return true;
+                        } else {
+                            updateSlack(u, base[v]);
+                        }
+                    }
+                }
+            }
+
+            long long d = LLONG_MAX;
+            for (int b = n + 1; b <= count; b++) {
+                if (base[b] == b && side[b] == 1) d = std::min(d, label[b] / 2);
+            }
+            for (int x = 1; x <= count; x++) {
+                if (base[x] == x && slack[x] != 0) {
+                    if (side[x] == -1) d = std::min(d, delta(g[slack[x]][x]));
+                    else if (side[x] == 0) d = std::min(d, delta(g[slack[x]][x]) / 2);
+                }
+            }
+            for (int u = 1; u <= n; u++) {
+                if (side[base[u]] == 0) {
+                    if (label[u] <= d) return false;
+                    label[u] -= d;
+                } else if (side[base[u]] == 1) {
+                    label[u] += d;
+                }
+            }
+            for (int b = n + 1; b <= count; b++) {
+                if (base[b] == b) {
+                    if (side[b] == 0) label[b] += 2 * d;
+                    else if (side[b] == 1) label[b] -= 2 * d;
+                }
+            }
+
+            q = std::queue<int>();
+            for (int x = 1; x <= count; x++) {
+                if (base[x] == x && slack[x] != 0 && base[slack[x]] != x && delta(g[slack[x]][x]) == 0) {
+                    if (onTightEdge(g[slack[x]][x])) return true;
+                }
+            }
+            for (int b = n + 1; b <= count; b++) {
+                if (base[b] == b && side[b] == 1 && label[b] == 0) expandBlossom(b);
+            }
+        }
+    }
+};
+
+}
+
+PerfectMatching::PerfectMatching(const Graph *graph, std::vector<int> vertices): graph(graph), vertices(std::move(vertices)) {}
+
+double PerfectMatching::getCost() const {
+    return cost;
+}
+
+double PerfectMatching::getTime() const {
+    return time;
+}
+
+MatchingMethod PerfectMatching::getMethod() const {
+    return method;
+}
+
+double PerfectMatching::distance(int i, int j) const {
+    return graph->getDistance(vertices[i], vertices[j]);
+}
+
+std::vector<std::pair<int, int>> PerfectMatching::solve(MatchingMethod method) {
+    auto start = std::chrono::steady_clock::now();
+    int k = vertices.size();
+    this->method = k > BLOSSOM_MAX_VERTICES ? greedyMatching : method;
+    mate.assign(k, -1);
+
+    if (this->method == exactMatching) {
+        blossom();
+    } else {
+        // the MATCHING_CANDIDATES closest vertices of each vertex
+        std::vector<std::vector<int>> candidates(k);
+        std::vector<std::pair<double, int>> closest;
+        for (int i = 0; i < k; i++) {
+            closest.clear();
+            for (int j = 0; j < k; j++) {
+                if (j != i) closest.emplace_back(distance(i, j), j);
+            }
+            auto middle = closest.begin() + std::min((int) closest.size(), MATCHING_CANDIDATES);
+            std::partial_sort(closest.begin(), middle, closest.end());
+            for (auto it = closest.begin(); it != middle; it++) {
+                candidates[i].push_back(it->second);
+            }
+        }
+
+        greedy(candidates);
+        improve(candidates);
+    }
+
+    std::vector<std::pair<int, int>> pairs;
+    cost = 0;
+    for (int i = 0; i < k; i++) {
+        if (i < mate[i]) {
+            pairs.emplace_back(vertices[i], vertices[mate[i]]);
+            cost += distance(i, mate[i]);
+        }
+    }
+
+    time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return pairs;
+}
+
+void PerfectMatching::blossom() {
+    int k = vertices.size();
+    double maxDistance = 0;
+    for (int i = 0; i < k; i++) {
+        for (int j = i + 1; j < k; j++) {
+            maxDistance = std::max(maxDistance, distance(i, j));
+        }
+    }
+
+    // the weights are the distances subtracted from the largest one, scaled to integers up to 10^9 so the duals stay exact
+    double scale = maxDistance > 0 ? 1e9 / maxDistance : 0;
+    Blossom solver(k);
+    for (int i = 0; i < k; i++) {
+        for (int j = i + 1; j < k; j++) {
+            solver.setWeight(i + 1, j + 1, std::llround((maxDistance - distance(i, j)) * scale) + 1);
+        }
+    }
+
+    std::vector<int> match = solver.solve();
+    for (int i = 0; i < k; i++) {
+        mate[i] = match[i + 1] - 1;
+    }
+}
+
+void PerfectMatching::greedy(const std::vector<std::vector<int>> &candidates) {
+    int k = vertices.size();
+    std::vector<std::pair<double, std::pair<int, int>>> pairs;
+    for (int i = 0; i < k; i++) {
+        for (int j : candidates[i]) {
+            if (i < j) pairs.push_back({distance(i, j), {i, j}});
+        }
+    }
+    std::sort(pairs.begin(), pairs.end());
+
+    for (auto &p : pairs) {
+        int i = p.second.first, j = p.second.second;
+        if (mate[i] < 0 && mate[j] < 0) {
+            mate[i] = j;
+            mate[j] = i;
+        }
+    }
+
+    std::vector<int> left;
+    for (int i = 0; i < k; i++) {
+        if (mate[i] < 0) left.push_back(i);
+    }
+    for (int a = 0; a < (int) left.size(); a++) {
+        int i = left[a];
+        if (mate[i] >= 0) continue;
+        double min = INF;
+        int closest = -1;
+        for (int b = a + 1; b < (int) left.size(); b++) {
+            int j = left[b];
+            if (mate[j] < 0 && distance(i, j) < min) {
+                min = distance(i, j);
+                closest = j;
+            }
+        }
+        if (closest >= 0) {
+            mate[i] = closest;
+            mate[closest] = i;
+        }
+    }
+}
+
+void PerfectMatching::improve(const std::vector<std::vector<int>> &candidates) {
+    int k = vertices.size();
+    std::deque<int> active;
+    std::vector<bool> queued(k, true);
+    for (int i = 0; i < k; i++) {
+        active.push_back(i);
+    }
+
+    while (!active.empty()) {
+        int a = active.front();
+        active.pop_front();
+        queued[a] = false;
+
+        int b = mate[a];
+        double ab = distance(a, b);
+        for (int c : candidates[a]) {
+            double ac = distance(a, c);
+            // the new pair {a, c} must be shorter than {a, b}, otherwise the swap is found from b or d
+            if (ac >= ab) break;
+            if (c == b) continue;
+            int d = mate[c];
+            if (ac + distance(b, d) < ab + distance(c, d) - EPSILON) {
+                mate[a] = c;
+                mate[c] = a;
+                mate[b] = d;
+                mate[d] = b;
+                for (int x : {a, b, c, d}) {
+                    if (!queued[x]) {
+                        queued[x] = true;
+                        active.push_back(x);
+                    }
+                }
+                break;
+            }
+        }
+    }
+}
@@ -0,0 +1,104 @@
+#ifndef ROUTING_ALGORITHM_PERFECT_MATCHING_H
+#define ROUTING_ALGORITHM_PERFECT_MATCHING_H
+
+/**
+* @file PerfectMatching.h
+* @brief Contains the declaration of the PerfectMatching class.
+* @author Luiz, Pedro e Raphael
+* @date 02/06/2023
+*/
+
+#include <vector>
+#include <utility>
+
+#define BLOSSOM_MAX_VERTICES 1000
+#define MATCHING_CANDIDATES 10
+
+class Graph;
+
+/**
+ * @brief The algorithm used by PerfectMatching.
+ */
+enum MatchingMethod {
+    exactMatching,  // minimum-weight perfect matching with Edmonds' blossom algorithm
+    greedyMatching  // greedy matching over candidate lists, improved with 2-opt style pair swaps
+};
+
+/**
+ * @class PerfectMatching
+ * @brief Computes a perfect matching of an even set of vertices of a graph, as needed by the Christofides algorithm.
+ *
+ * The distance between two vertices is Graph::getDistance, so every pair can be matched even if the graph has no edge between them.
+ * The cost and the time of the last matching are kept so that the quality and the latency of both methods can be compared.
+ */
+class PerfectMatching {
+public:
+    /**
+    * @brief Constructs a PerfectMatching object over a set of vertices.
+    * @param graph The graph that holds the vertices.
+    * @param vertices The IDs of the vertices to match. Their number must be even.
+    * @complexity O(1)
+    */
+    PerfectMatching(const Graph *graph, std::vector<int> vertices);
+
+    /**
+    * @brief Computes a perfect matching of the vertices.
+    *
+    * The exact method falls back to the greedy one when there are more than BLOSSOM_MAX_VERTICES vertices,
+    * since it needs O(k^2) memory.
+    *
+    * @param method The algorithm used.
+    * @return The matched pairs of vertex IDs.
+    * @complexity O(k^3) with the exact method, O(k^2) with the greedy method, where k is the number of vertices.
+    */
+    std::vector<std::pair<int, int>> solve(MatchingMethod method);
+
+    /**
+    * @brief Returns the total distance of the pairs of the last matching.
+    * @return The cost of the matching.
+    * @complexity O(1)
+    */
+    double getCost() const;
+
+    /**
+    * @brief Returns the time taken by the last matching.
+    * @return The time in seconds.
+    * @complexity O(1)
+    */
+    double getTime() const;
+
+    /**
+    * @brief Returns the method used by the last matching, which is greedyMatching if the exact method fell back to it.
+    * @return The method used.
+    * @complexity O(1)
+    */
+    MatchingMethod getMethod() const;
+
+private:
+    const Graph *graph;
+    std::vector<int> vertices;
+    std::vector<int> mate;
+
+    double cost = 0;
+    double time = 0;
+    MatchingMethod method = exactMatching;
+
+    double distance(int i, int j) const;
+
+    /**
+    * @brief Matches the vertices with Edmonds' blossom algorithm on the distances scaled to integers.
+    */
+    void blossom();
+
+    /**
+    * @brief Matches the closest free pairs of the candidate lists first and the vertices left over with their closest free vertex.
+    */
+    void greedy(const std::vector<std::vector<int>> &candidates);
+
+    /**
+    * @brief Replaces pairs {a, b}, {c, d} by {a, c}, {b, d} while it reduces the cost, where c is a candidate of a.
+    */
+    void improve(const std::vector<std::vector<int>> &candidates);
+};
+
+#endif
@@ -0,0 +1,87 @@
+#include "RootedTree.h"
+
+#include <algorithm>
+
+RootedTree::RootedTree(int root, std::vector<int> parent, std::vector<double> weight, std::vector<int> order):
+    root(root), parent(std::move(parent)), weight(std::move(weight)), order(std::move(order)) {
+    int n = this->parent.size();
+    offset.assign(n + 1, 0);
+    for (int v = 0; v < n; v++) {
+        if (this->parent[v] >= 0) {
+            offset[this->parent[v] + 1]++;
+        }
+    }
+    for (int v = 0; v < n; v++) {
+        offset[v + 1] += offset[v];
+    }
+
+    std::vector<int> cursor(offset.begin(), offset.end() - 1);
+    children.resize(offset[n]);
+    for (int v = 0; v < n; v++) {
+        if (this->parent[v] >= 0) {
+            children[cursor[this->parent[v]]++] = v;
+        }
+    }
+    for (int v = 0; v < n; v++) {
+        std::stable_sort(children.begin() + offset[v], children.begin() + offset[v + 1], [this](int a, int b) {
+            return this->weight[a] < this->weight[b];
+        });
+    }
+
+    if (root < 0 || root >= n) {
+        return;
+    }
+    std::vector<int> stack = {root};
+    while (!stack.empty()) {
+        int v = stack.back();
+        stack.pop_back();
+        preorder.push_back(v);
+        for (int i = offset[v + 1] - 1; i >= offset[v]; i--) {
+            stack.push_back(children[i]);
+        }
+    }
+}
+
+int RootedTree::size() const {
+    return parent.size();
+}
+
+int RootedTree::getRoot() const {
+    return root;
+}
+
+int RootedTree::getParent(int v) const {
+    return parent[v];
+}
+
+double RootedTree::getWeight(int v) const {
+    return weight[v];
+}
+
+int RootedTree::getDegree(int v) const {
+    return offset[v + 1] - offset[v] + (parent[v] >= 0 ? 1 : 0);
+}
+
+int RootedTree::getNumChildren(int v) const {
+    return offset[v + 1] - offset[v];
+}
+
+int RootedTree::getChild(int v, int i) const {
+    return children[offset[v] + i];
+}
+
+const std::vector<int> &RootedTree::getPreorder() const {
+    return preorder;
+}
+
+const std::vector<int> &RootedTree::getOrder() const {
+    return order;
+}
+
+const std::vector<int> &RootedTree::getParents() const {
+    return parent;
+}
+
+const std::vector<double> &RootedTree::getWeights() const {
+    return weight;
+}
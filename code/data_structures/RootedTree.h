@@ -0,0 +1,115 @@
+#ifndef ROUTING_ALGORITHM_ROOTED_TREE_H
+#define ROUTING_ALGORITHM_ROOTED_TREE_H
+
+/**
+* @file RootedTree.h
+* @brief Contains the declaration of the RootedTree class.
+* @author Luiz, Pedro e Raphael
+* @date 02/06/2023
+*/
+
+#include <vector>
+
+/**
+ * @class RootedTree
+ * @brief A rooted tree over the vertices 0 to n - 1, such as the minimum spanning tree returned by Graph::prim.
+ *
+ * The children of every vertex are stored contiguously (children[offset[v]] to children[offset[v + 1] - 1]) and sorted
+ * by increasing weight of the edge to their parent, so walking the tree never scans the adjacency of the graph.
+ * Vertices that are not reachable from the root have no parent and are not in the preorder.
+ */
+class RootedTree {
+public:
+    RootedTree() = default;
+
+    /**
+    * @brief Constructs a RootedTree from the parent of every vertex.
+    *
+    * The parents may also form cycles away from the root, which is what Graph::heuristicVisit leaves; those vertices are
+    * kept in the child lists but are not in the preorder.
+    *
+    * @param root The root of the tree.
+    * @param parent The parent of every vertex, or -1 for the root and the vertices outside the tree.
+    * @param weight The weight of the edge from every vertex to its parent.
+    * @param order The vertices in the order they joined the tree, if it matters to the caller.
+    * @complexity O(n log n) to sort the children, O(n) to build the rest.
+    */
+    RootedTree(int root, std::vector<int> parent, std::vector<double> weight, std::vector<int> order = {});
+
+    /**
+    * @brief Returns the number of vertices, including the ones outside the tree.
+    * @complexity O(1)
+    */
+    int size() const;
+
+    /**
+    * @brief Returns the root of the tree, or -1 if the tree is empty.
+    * @complexity O(1)
+    */
+    int getRoot() const;
+
+    /**
+    * @brief Returns the parent of a vertex, or -1 for the root and the vertices outside the tree.
+    * @complexity O(1)
+    */
+    int getParent(int v) const;
+
+    /**
+    * @brief Returns the weight of the edge from a vertex to its parent.
+    * @complexity O(1)
+    */
+    double getWeight(int v) const;
+
+    /**
+    * @brief Returns the number of tree edges of a vertex (its children plus its parent).
+    * @complexity O(1)
+    */
+    int getDegree(int v) const;
+
+    /**
+    * @brief Returns the number of children of a vertex.
+    * @complexity O(1)
+    */
+    int getNumChildren(int v) const;
+
+    /**
+    * @brief Returns the i-th child of a vertex, in increasing order of the weight of its edge.
+    * @complexity O(1)
+    */
+    int getChild(int v, int i) const;
+
+    /**
+    * @brief Returns the vertices reachable from the root in preorder, visiting the children by increasing edge weight.
+    * @complexity O(1)
+    */
+    const std::vector<int> &getPreorder() const;
+
+    /**
+    * @brief Returns the vertices in the order they joined the tree (the extraction order of Prim's algorithm).
+    * @complexity O(1)
+    */
+    const std::vector<int> &getOrder() const;
+
+    /**
+    * @brief Returns the parent of every vertex, to build a modified copy of the tree.
+    * @complexity O(1)
+    */
+    const std::vector<int> &getParents() const;
+
+    /**
+    * @brief Returns the weight of the edge from every vertex to its parent.
+    * @complexity O(1)
+    */
+    const std::vector<double> &getWeights() const;
+
+private:
+    int root = -1;
+    std::vector<int> parent;
+    std::vector<double> weight;
+    std::vector<int> offset;
+    std::vector<int> children;
+    std::vector<int> preorder;
+    std::vector<int> order;
+};
+
+#endif
@@ -0,0 +1,221 @@
+#include "Tour.h"
+
+Tour::Tour() = default;
+
+Tour::Tour(const std::vector<int> &order): Tour(order, order.size() >= TWO_LEVEL_THRESHOLD) {}
+
+Tour::Tour(const std::vector<int> &order, bool twoLevel): n(order.size()), twoLevel(twoLevel) {
+    // every city is an index of the backend, so anything but a permutation of 0 to n - 1 gives an empty tour
+    std::vector<bool> seen(n, false);
+    for (int c : order) {
+        if (c < 0 || c >= n || seen[c]) {
+            n = 0;
+            return;
+        }
+        seen[c] = true;
+    }
+
+    if (twoLevel) {
+        segOf.resize(n);
+        idx.resize(n);
+        build(order);
+    } else {
+        this->order = order;
+        pos.resize(n);
+        for (int i = 0; i < n; i++) {
+            pos[order[i]] = i;
+        }
+    }
+}
+
+int Tour::size() const {
+    return n;
+}
+
+bool Tour::empty() const {
+    return n == 0;
+}
+
+bool Tour::isTwoLevel() const {
+    return twoLevel;
+}
+
+int Tour::offset(int c) const {
+    int s = segOf[c];
+    return reversed[s] ? segments[s].size() - 1 - idx[c] : idx[c];
+}
+
+int Tour::cityAt(int s, int o) const {
+    return reversed[s] ? segments[s][segments[s].size() - 1 - o] : segments[s][o];
+}
+
+int Tour::next(int c) const {
+    if (!twoLevel) {
+        return order[(pos[c] + 1) % n];
+    }
+
+    int s = segOf[c];
+    int o = offset(c) + 1;
+    if (o < (int) segments[s].size()) {
+        return cityAt(s, o);
+    }
+    return cityAt(segOrder[(rank[s] + 1) % segOrder.size()], 0);
+}
+
+int Tour::prev(int c) const {
+    if (!twoLevel) {
+        return order[(pos[c] + n - 1) % n];
+    }
+
+    int s = segOf[c];
+    int o = offset(c) - 1;
+    if (o >= 0) {
+        return cityAt(s, o);
+    }
+    int p = segOrder[(rank[s] + segOrder.size() - 1) % segOrder.size()];
+    return cityAt(p, segments[p].size() - 1);
+}
+
+bool Tour::between(int a, int b, int c) const {
+    auto key = [this](int x) {
+        if (!twoLevel) return (long long) pos[x];
+        return (long long) rank[segOf[x]] * (n + 1) + offset(x);
+    };
+
+    long long ka = key(a), kb = key(b), kc = key(c);
+    if (ka <= kc) {
+        return ka <= kb && kb <= kc;
+    }
+    return kb >= ka || kb <= kc;
+}
+
+void Tour::flip(int a, int b) {
+    if (a == b || next(b) == a) {
+        return;
+    }
+
+    if (!twoLevel) {
+        int i = pos[a], j = pos[b];
+        int len = (j - i + n) % n + 1;
+
+        if (2 * len > n) {
+            int tmp = i;
+            i = (j + 1) % n;
+            j = (tmp + n - 1) % n;
+            len = n - len;
+        }
+
+        for (int k = 0; k < len / 2; k++) {
+            int x = (i + k) % n, y = (j - k + n) % n;
+            std::swap(order[x], order[y]);
+            pos[order[x]] = x;
+            pos[order[y]] = y;
+        }
+        return;
+    }
+
+    splitBefore(a);
+    splitBefore(next(b));
+
+    int m = segOrder.size();
+    int i = rank[segOf[a]], j = rank[segOf[b]];
+    int length = (j - i + m) % m + 1;
+    if (2 * length > m) {
+        i = (j + 1) % m;
+        length = m - length;
+    }
+    reverseSegments(i, length);
+
+    // every flip adds at most two segments, so rebuilding when they double keeps flips amortized O(sqrt(n))
+    if ((int) segOrder.size() > 2 * ((n + groupSize - 1) / groupSize)) {
+        build(toVector(cityAt(segOrder[0], 0)));
+    }
+}
+
+void Tour::splitBefore(int c) {
+    int s = segOf[c];
+    int o = offset(c);
+    if (o == 0) {
+        return;
+    }
+
+    int t = segments.size();
+    segments.emplace_back();
+    reversed.push_back(reversed[s]);
+
+    std::vector<int> &cities = segments[s];
+    int size = cities.size();
+    if (!reversed[s]) {
+        segments[t].assign(cities.begin() + o, cities.end());
+        cities.resize(o);
+    } else {
+        segments[t].assign(cities.begin(), cities.begin() + (size - o));
+        cities.erase(cities.begin(), cities.begin() + (size - o));
+        for (unsigned int k = 0; k < cities.size(); k++) {
+            idx[cities[k]] = k;
+        }
+    }
+
+    for (unsigned int k = 0; k < segments[t].size(); k++) {
+        segOf[segments[t][k]] = t;
+        idx[segments[t][k]] = k;
+    }
+
+    segOrder.insert(segOrder.begin() + rank[s] + 1, t);
+    rank.push_back(0);
+    for (unsigned int r = rank[s] + 1; r < segOrder.size(); r++) {
+        rank[segOrder[r]] = r;
+    }
+}
+
+void Tour::reverseSegments(int i, int length) {
+    int m = segOrder.size();
+    for (int k = 0; k < length / 2; k++) {
+        std::swap(segOrder[(i + k) % m], segOrder[(i + length - 1 - k) % m]);
+    }
+    for (int k = 0; k < length; k++) {
+        int s = segOrder[(i + k) % m];
+        rank[s] = (i + k) % m;
+        reversed[s] = !reversed[s];
+    }
+}
+
+void Tour::build(const std::vector<int> &cities) {
+    groupSize = std::max(8, (int) std::sqrt((double) n));
+    int count = (n + groupSize - 1) / groupSize;
+
+    segments.assign(count, std::vector<int>());
+    reversed.assign(count, false);
+    segOrder.resize(count);
+    rank.resize(count);
+
+    for (int i = 0; i < n; i++) {
+        int s = i / groupSize;
+        segOf[cities[i]] = s;
+        idx[cities[i]] = segments[s].size();
+        segments[s].push_back(cities[i]);
+    }
+    for (int s = 0; s < count; s++) {
+        segOrder[s] = s;
+        rank[s] = s;
+    }
+}
+
+std::vector<int> Tour::toVector(int start) const {
+    std::vector<int> cities;
+    cities.reserve(n);
+    int c = start;
+    for (int i = 0; i < n; i++) {
+        cities.push_back(c);
+        c = next(c);
+    }
+    return cities;
+}
+
+std::vector<int> Tour::getPath(int start) const {
+    std::vector<int> path = toVector(start);
+    if (n > 0) {
+        path.push_back(start);
+    }
+    return path;
+}
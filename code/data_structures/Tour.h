@@ -0,0 +1,158 @@
+#ifndef ROUTING_ALGORITHM_TOUR_H
+#define ROUTING_ALGORITHM_TOUR_H
+
+/**
+* @file Tour.h
+* @brief Contains the declaration of the Tour class.
+* @author Luiz, Pedro e Raphael
+* @date 02/06/2023
+*/
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+#define TWO_LEVEL_THRESHOLD 1000
+
+/**
+ * @class Tour
+ * @brief Represents a TSP tour over the cities 0 to n - 1.
+ *
+ * Small tours are stored as an array with the position of each city, where a flip costs O(n).
+ * Tours with at least TWO_LEVEL_THRESHOLD cities use a two-level list: the cities are split in about sqrt(n)
+ * segments, each one with a reversed bit, so a flip only splits two segments and reverses the order of the
+ * segments in between, in O(sqrt(n)).
+ *
+ * A flip may reverse the complement of the requested path, which gives the same cycle with the opposite
+ * orientation, so next and prev must be queried again after every flip.
+ */
+class Tour {
+public:
+    /**
+    * @brief Constructs an empty tour.
+    */
+    Tour();
+
+    /**
+    * @brief Constructs a tour that visits the cities in the given order, choosing the backend by its size.
+    * @param order A permutation of the cities 0 to n - 1, otherwise the tour is empty.
+    * @complexity O(n)
+    */
+    explicit Tour(const std::vector<int> &order);
+
+    /**
+    * @brief Constructs a tour that visits the cities in the given order with the chosen backend.
+    * @param order A permutation of the cities 0 to n - 1, otherwise the tour is empty.
+    * @param twoLevel True to use the two-level list, false to use the array.
+    * @complexity O(n)
+    */
+    Tour(const std::vector<int> &order, bool twoLevel);
+
+    /**
+    * @brief Returns the number of cities in the tour.
+    * @complexity O(1)
+    */
+    int size() const;
+
+    /**
+    * @brief Checks if the tour has no cities.
+    * @complexity O(1)
+    */
+    bool empty() const;
+
+    /**
+    * @brief Checks if the tour uses the two-level list backend.
+    * @complexity O(1)
+    */
+    bool isTwoLevel() const;
+
+    /**
+    * @brief Returns the city after c in the tour.
+    * @complexity O(1)
+    */
+    int next(int c) const;
+
+    /**
+    * @brief Returns the city before c in the tour.
+    * @complexity O(1)
+    */
+    int prev(int c) const;
+
+    /**
+    * @brief Checks if b is on the path from a to c, following next (both ends included).
+    * @complexity O(1)
+    */
+    bool between(int a, int b, int c) const;
+
+    /**
+    * @brief Reverses the path from a to b, following next.
+    *
+    * The complement of the path is reversed instead when it is shorter.
+    *
+    * @complexity O(n) with the array, amortized O(sqrt(n)) with the two-level list.
+    */
+    void flip(int a, int b);
+
+    /**
+    * @brief Returns the cities of the tour in order.
+    * @param start The first city.
+    * @return The n cities of the tour, starting at start.
+    * @complexity O(n)
+    */
+    std::vector<int> toVector(int start) const;
+
+    /**
+    * @brief Returns the closed path of the tour.
+    * @param start The first and last city of the path.
+    * @return The n + 1 cities of the path.
+    * @complexity O(n)
+    */
+    std::vector<int> getPath(int start) const;
+
+private:
+    int n = 0;
+    bool twoLevel = false;
+
+    // array backend
+    std::vector<int> order; // cities in tour order
+    std::vector<int> pos;   // position of each city in order
+
+    // two-level list backend
+    std::vector<int> segOf;                 // segment of each city
+    std::vector<int> idx;                   // index of each city in its segment
+    std::vector<std::vector<int>> segments; // cities of each segment
+    std::vector<bool> reversed;             // reversed bit of each segment
+    std::vector<int> segOrder;              // segments in tour order
+    std::vector<int> rank;                  // position of each segment in segOrder
+    int groupSize = 1;
+
+    /**
+    * @brief Returns the position of city c inside its segment, following the orientation of the segment.
+    */
+    int offset(int c) const;
+
+    /**
+    * @brief Returns the city at position o of segment s, following the orientation of the segment.
+    */
+    int cityAt(int s, int o) const;
+
+    /**
+    * @brief Splits the segment of c so that c becomes its first city.
+    * @complexity O(sqrt(n))
+    */
+    void splitBefore(int c);
+
+    /**
+    * @brief Reverses the segments at positions i to i + length - 1 of segOrder (cyclically) and toggles their reversed bits.
+    */
+    void reverseSegments(int i, int length);
+
+    /**
+    * @brief Rebuilds the two-level list with segments of about sqrt(n) cities.
+    * @param cities The cities in tour order.
+    * @complexity O(n)
+    */
+    void build(const std::vector<int> &cities);
+};
+
+#endif
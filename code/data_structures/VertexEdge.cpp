@@ -237,6 +237,10 @@ void Edge::setReverse(Edge *reverse) {
     this->reverse = reverse;
 }
 
+void Edge::setWeight(double weight) {
+    this->weight = weight;
+}
+
 void Edge::setFlow(double flow) {
     this->flow = flow;
 }
@@ -373,6 +373,13 @@ public:
  */
     void setReverse(Edge *reverse);
 
+    /**
+ * @brief Sets the weight of the edge.
+ * @param weight The new weight of the edge.
+ * @complexity O(1)
+ */
+    void setWeight(double weight);
+
     /**
  * @brief Sets the flow of the edge.
  * @param flow The flow of the edge.